@@ -469,10 +469,10 @@ AlpsKnowledge * AbcTreeNode::decode(AlpsEncoded& encoded) const {
     int numCols;
     double* lb;
     double* ub;
-    int index;
+    AlpsNodeIndex_t index;
     int depth;
     double objValue;
-    int parentIndex;
+    AlpsNodeIndex_t parentIndex;
     int numChildren;
     AlpsNodeStatus     nodeStatus;
     int sentMark;
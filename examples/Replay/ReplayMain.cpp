@@ -0,0 +1,74 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+// Replays a search tree recorded with Alps_eventLogFile, see AlpsReplay.h.
+// Alps_instance names the event log, or the logs of a parallel run
+// separated by commas.
+
+#include "AlpsConfig.h"
+
+#include <iostream>
+
+#include "CoinError.hpp"
+
+#include "AlpsKnowledgeBrokerSerial.h"
+#include "AlpsReplay.h"
+
+//#############################################################################
+
+int main(int argc, char* argv[])
+{
+
+    try{
+        // 1: Declare the model and knowledge broker. Replays run on one
+        // process only; the broker reads the event logs.
+        AlpsReplayModel model;
+        AlpsKnowledgeBrokerSerial broker(argc, argv, model);
+
+        // 2: Register solution and tree node
+        broker.registerClass(AlpsKnowledgeTypeSolution,
+                             new AlpsReplaySolution());
+        broker.registerClass(AlpsKnowledgeTypeNode,
+                             new AlpsReplayTreeNode(&model));
+
+        // 3: Search the recorded tree
+        broker.search(&model);
+
+        // 4: Report the best solution found and its objective value
+        broker.printBestSolution();
+    }
+    catch(CoinError& er) {
+        std::cerr << "ERROR:" << er.message() << std::endl
+                  << " from function " << er.methodName() << std::endl
+                  << " from class " << er.className() << std::endl;
+    }
+    catch(...) {
+        std::cerr << "Something went wrong!" << std::endl;
+    }
+
+    return 0;
+}
+
+//#############################################################################
@@ -28,6 +28,7 @@
 #define Alps_h_
 
 #include <cfloat>
+#include <cstdint>
 #include <cstdio>
 
 #include "AlpsConfig.h"
@@ -171,7 +172,13 @@
 #define ALPS_MEMORY_USAGE 1
 #endif
 
-typedef int AlpsNodeIndex_t;
+/** A node index holds the rank of the process that created the node in
+    its high bits and a counter local to that process in the low
+    ALPS_NODE_INDEX_LOCAL_BITS bits, so processes never run out of indices
+    or need to ask for more. */
+typedef int64_t AlpsNodeIndex_t;
+
+#define ALPS_NODE_INDEX_LOCAL_BITS 40
 
 //#############################################################################
 /** The possible values for clock type. */
@@ -188,7 +195,29 @@ enum AlpsClockType {
 
 enum AlpsStaticBalanceScheme {
     AlpsRootInit = 0,
-    AlpsSpiral
+    AlpsSpiral,
+    AlpsRacing
+};
+
+//#############################################################################
+/** The possible values for dynamic load balancing scheme. */
+//#############################################################################
+
+enum AlpsDynamicBalanceScheme {
+    AlpsHierarchicalBalance = 0,
+    AlpsWorkStealing
+};
+
+//#############################################################################
+/** The possible topologies for sharing generated model knowledge. */
+//#############################################################################
+
+enum AlpsKnowledgeTopology {
+    AlpsKnowledgeTree = 0,
+    AlpsKnowledgeRing,
+    AlpsKnowledgeHypercube,
+    AlpsKnowledgeGossip,
+    AlpsKnowledgeHubMediated
 };
 
 //#############################################################################
@@ -0,0 +1,154 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#include "CoinError.hpp"
+
+#include "AlpsAsyncWriter.h"
+
+//#############################################################################
+
+AlpsAsyncWriter::AlpsAsyncWriter(const std::string& fileName)
+  :
+  fileName_(fileName),
+  file_(NULL),
+  done_(false),
+  failed_(false),
+  numBytes_(0)
+{
+  file_ = fopen(fileName_.c_str(), "wb");
+  if (file_ == NULL) {
+    throw CoinError("Failed to open file", "AlpsAsyncWriter",
+                    "AlpsAsyncWriter");
+  }
+  thread_ = std::thread(&AlpsAsyncWriter::run, this);
+}
+
+//#############################################################################
+
+AlpsAsyncWriter::~AlpsAsyncWriter()
+{
+  close();
+}
+
+//#############################################################################
+
+void
+AlpsAsyncWriter::write(const char* data, long size)
+{
+  if (size <= 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_ || failed_) {
+      return;
+    }
+    pending_.append(data, size);
+  }
+  numBytes_ += size;
+  ready_.notify_one();
+}
+
+//#############################################################################
+
+void
+AlpsAsyncWriter::write(std::string& buffer)
+{
+  if (buffer.empty()) {
+    return;
+  }
+  long size = static_cast<long>(buffer.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_ || failed_) {
+      buffer.clear();
+      return;
+    }
+    if (pending_.empty()) {
+      pending_.swap(buffer);
+    }
+    else {
+      pending_.append(buffer);
+    }
+  }
+  buffer.clear();
+  numBytes_ += size;
+  ready_.notify_one();
+}
+
+//#############################################################################
+
+void
+AlpsAsyncWriter::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_) {
+      return;
+    }
+    done_ = true;
+  }
+  ready_.notify_one();
+  thread_.join();
+  fclose(file_);
+  file_ = NULL;
+}
+
+//#############################################################################
+
+void
+AlpsAsyncWriter::run()
+{
+  std::string buffer;
+  bool done = false;
+
+  while (!done) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (pending_.empty() && !done_) {
+        ready_.wait(lock);
+      }
+      // Take everything queued so far; writers continue with an empty
+      // buffer while this one goes to disk.
+      buffer.swap(pending_);
+      done = done_;
+    }
+
+    if (!buffer.empty()) {
+      size_t written = fwrite(buffer.data(), 1, buffer.size(), file_);
+      if (written != buffer.size() || fflush(file_) != 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed_ = true;
+        pending_.clear();
+        done = true;
+      }
+      buffer.clear();
+    }
+  }
+}
+
+//#############################################################################
@@ -0,0 +1,101 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#ifndef AlpsAsyncWriter_h_
+#define AlpsAsyncWriter_h_
+
+#include "AlpsConfig.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+//#############################################################################
+
+/** Appends bytes to a file from a background thread. Writers only copy
+    their data into a memory buffer; the background thread swaps the
+    buffer out, writes it and flushes the file, so the caller never waits
+    for the disk. */
+class ALPSLIB_EXPORT AlpsAsyncWriter {
+
+ private:
+
+  /** The output file name. */
+  std::string fileName_;
+  /** The output file, only touched by the background thread. */
+  FILE* file_;
+  /** Data waiting to be written. */
+  std::string pending_;
+  /** Protects pending_, done_ and failed_. */
+  std::mutex mutex_;
+  /** Signals the background thread that there is data or it should exit. */
+  std::condition_variable ready_;
+  /** Set when the writer is closed. */
+  bool done_;
+  /** Set when a write failed. Later data is dropped. */
+  bool failed_;
+  /** Number of bytes handed to the writer. */
+  long numBytes_;
+  /** The background thread. */
+  std::thread thread_;
+
+  /** Body of the background thread. */
+  void run();
+
+  AlpsAsyncWriter(const AlpsAsyncWriter&);
+  AlpsAsyncWriter& operator=(const AlpsAsyncWriter&);
+
+ public:
+  /** Truncate the given file and start the background thread. */
+  AlpsAsyncWriter(const std::string& fileName);
+  /** Write the remaining data and close the file. */
+  ~AlpsAsyncWriter();
+
+  /** Queue a copy of the given bytes. */
+  void write(const char* data, long size);
+
+  /** Queue the contents of the given buffer and leave it empty. */
+  void write(std::string& buffer);
+
+  /** Write the remaining data, stop the background thread and close the
+      file. Further writes are dropped. */
+  void close();
+
+  /** @name Query methods */
+  //@{
+  const std::string& getFileName() const { return fileName_; }
+  long getNumBytes() const { return numBytes_; }
+  bool failed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+  }
+  //@}
+};
+
+#endif
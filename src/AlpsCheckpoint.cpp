@@ -0,0 +1,364 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+#include <cstring>
+
+#include "AlpsCheckpoint.h"
+
+//#############################################################################
+
+/** Size of a payload after padding to a multiple of 8 bytes. */
+static inline long paddedSize(int size)
+{
+  return (static_cast<long>(size) + 7) & ~7L;
+}
+
+//#############################################################################
+
+AlpsCheckpointReader::AlpsCheckpointReader(const std::string& fileName)
+  :
+  file_(fileName),
+  committedLength_(0),
+  nextIndex_(0)
+{
+  scan();
+}
+
+//#############################################################################
+
+void
+AlpsCheckpointReader::scan()
+{
+  // Changes since the last mark; applied when the next mark is seen.
+  std::map<int, Entry> pending;
+  std::map<int, Entry>::iterator pos;
+
+  const long headerSize = static_cast<long>(sizeof(AlpsCheckpointRecord));
+  long offset = 0;
+  Entry entry;
+
+  const long length = file_.length();
+
+  while (offset + headerSize <= length) {
+    memcpy(&entry.header, file_.data() + offset, headerSize);
+    if (entry.header.magic != ALPS_CHECKPOINT_MAGIC ||
+        entry.header.size < 0) {
+      break;  // Torn write.
+    }
+    long recordSize = headerSize + paddedSize(entry.header.size);
+    if (offset + recordSize > length) {
+      break;  // Torn write.
+    }
+    entry.offset = offset;
+
+    switch (entry.header.type) {
+    case AlpsCheckpointRecordSubTree:
+    case AlpsCheckpointRecordSolution:
+    case AlpsCheckpointRecordRemove:
+      pending[entry.header.id] = entry;
+      break;
+    case AlpsCheckpointRecordMark:
+      for (pos = pending.begin(); pos != pending.end(); ++pos) {
+        if (pos->second.header.type == AlpsCheckpointRecordRemove) {
+          entries_.erase(pos->first);
+        }
+        else {
+          entries_[pos->first] = pos->second;
+        }
+      }
+      pending.clear();
+      nextIndex_ = entry.header.aux;
+      committedLength_ = offset + recordSize;
+      break;
+    default:
+      throw CoinError("Unknown record type", "scan", "AlpsCheckpointReader");
+    }
+
+    offset += recordSize;
+  }
+}
+
+//#############################################################################
+
+AlpsEncoded*
+AlpsCheckpointReader::encoded(const Entry& entry) const
+{
+  char* rep = new char [entry.header.size + 1];
+  memcpy(rep, payload(entry), entry.header.size);
+  // AlpsEncoded takes over rep.
+  return new AlpsEncoded(entry.header.knowledgeType, entry.header.size, rep);
+}
+
+//#############################################################################
+
+AlpsCheckpoint::AlpsCheckpoint(const std::string& fileName,
+                               bool resume,
+                               double compactFactor)
+  :
+  fileName_(fileName),
+  file_(NULL),
+  compactFactor_(compactFactor),
+  logBytes_(0),
+  liveBytes_(0),
+  nextId_(0),
+  nextIndex_(0),
+  numCommits_(0),
+  numCompactions_(0)
+{
+  bool torn = false;
+
+  if (resume) {
+    AlpsCheckpointReader reader(fileName_);
+    std::map<int, AlpsCheckpointReader::Entry>::const_iterator pos;
+    for (pos = reader.entries().begin(); pos != reader.entries().end();
+         ++pos) {
+      long recordSize = sizeof(AlpsCheckpointRecord) +
+        paddedSize(pos->second.header.size);
+      live_[pos->first] = std::make_pair(pos->second.offset, recordSize);
+      liveBytes_ += recordSize;
+      if (pos->first >= nextId_) {
+        nextId_ = pos->first + 1;
+      }
+    }
+    nextIndex_ = reader.getNextIndex();
+    logBytes_ = reader.getLength();
+    torn = (reader.getCommittedLength() < reader.getLength());
+  }
+
+  if (torn) {
+    // Drop the uncommitted tail by rewriting the log.
+    compact();
+  }
+  else if (resume) {
+    openAppend();
+  }
+  else {
+    file_ = fopen(fileName_.c_str(), "wb");
+    if (file_ == NULL) {
+      throw CoinError("Failed to open checkpoint file",
+                      "AlpsCheckpoint", "AlpsCheckpoint");
+    }
+  }
+}
+
+//#############################################################################
+
+AlpsCheckpoint::~AlpsCheckpoint()
+{
+  if (file_) {
+    fclose(file_);
+    file_ = NULL;
+  }
+}
+
+//#############################################################################
+
+void
+AlpsCheckpoint::openAppend()
+{
+  file_ = fopen(fileName_.c_str(), "ab");
+  if (file_ == NULL) {
+    throw CoinError("Failed to open checkpoint file",
+                    "openAppend", "AlpsCheckpoint");
+  }
+}
+
+//#############################################################################
+
+long
+AlpsCheckpoint::append(FILE* out,
+                       AlpsCheckpointRecord& header,
+                       const char* payload)
+{
+  static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+  header.magic = ALPS_CHECKPOINT_MAGIC;
+
+  long pad = paddedSize(header.size) - header.size;
+  size_t expected = 1;
+  size_t written = fwrite(&header, sizeof(AlpsCheckpointRecord), 1, out);
+  if (header.size > 0) {
+    written += fwrite(payload, header.size, 1, out);
+    ++expected;
+  }
+  if (pad > 0) {
+    written += fwrite(zeros, pad, 1, out);
+    ++expected;
+  }
+  if (written != expected) {
+    throw CoinError("Failed to write checkpoint file",
+                    "append", "AlpsCheckpoint");
+  }
+
+  return sizeof(AlpsCheckpointRecord) + header.size + pad;
+}
+
+//#############################################################################
+
+void
+AlpsCheckpoint::write(int id, const AlpsKnowledge* kl, double quality)
+{
+  AlpsCheckpointRecord header;
+  memset(&header, 0, sizeof(AlpsCheckpointRecord));
+
+  switch (kl->getType()) {
+  case AlpsKnowledgeTypeSubTree:
+    header.type = AlpsCheckpointRecordSubTree;
+    break;
+  case AlpsKnowledgeTypeSolution:
+    header.type = AlpsCheckpointRecordSolution;
+    break;
+  default:
+    throw CoinError("Only subtrees and solutions can be checkpointed",
+                    "write", "AlpsCheckpoint");
+  }
+
+  AlpsEncoded* enc = kl->encode();
+  header.id = id;
+  header.knowledgeType = enc->type();
+  header.quality = quality;
+  header.size = enc->size();
+
+  long offset = logBytes_;
+  long recordSize = append(file_, header, enc->representation());
+  delete enc;
+
+  std::map<int, std::pair<long, long> >::iterator pos = live_.find(id);
+  if (pos != live_.end()) {
+    liveBytes_ -= pos->second.second;
+  }
+  live_[id] = std::make_pair(offset, recordSize);
+  liveBytes_ += recordSize;
+  logBytes_ += recordSize;
+}
+
+//#############################################################################
+
+void
+AlpsCheckpoint::remove(int id)
+{
+  std::map<int, std::pair<long, long> >::iterator pos = live_.find(id);
+  if (pos == live_.end()) {
+    return;
+  }
+
+  AlpsCheckpointRecord header;
+  memset(&header, 0, sizeof(AlpsCheckpointRecord));
+  header.type = AlpsCheckpointRecordRemove;
+  header.id = id;
+  logBytes_ += append(file_, header, NULL);
+
+  liveBytes_ -= pos->second.second;
+  live_.erase(pos);
+}
+
+//#############################################################################
+
+void
+AlpsCheckpoint::commit(AlpsNodeIndex_t nextIndex)
+{
+  AlpsCheckpointRecord header;
+  memset(&header, 0, sizeof(AlpsCheckpointRecord));
+  header.type = AlpsCheckpointRecordMark;
+  header.id = static_cast<int>(live_.size());
+  header.aux = nextIndex;
+  logBytes_ += append(file_, header, NULL);
+  fflush(file_);
+
+  nextIndex_ = nextIndex;
+  ++numCommits_;
+
+  // Small logs are not worth rewriting.
+  const long minCompactBytes = 1 << 20;
+  if (logBytes_ > minCompactBytes &&
+      logBytes_ > compactFactor_ * (liveBytes_ + sizeof(header))) {
+    compact();
+  }
+}
+
+//#############################################################################
+
+void
+AlpsCheckpoint::compact()
+{
+  if (file_) {
+    fclose(file_);
+    file_ = NULL;
+  }
+
+  std::string tempName = fileName_ + ".tmp";
+  std::map<int, std::pair<long, long> > newLive;
+  long newBytes = 0;
+
+  {
+    AlpsCheckpointReader reader(fileName_);
+
+    FILE* out = fopen(tempName.c_str(), "wb");
+    if (out == NULL) {
+      throw CoinError("Failed to open checkpoint file",
+                      "compact", "AlpsCheckpoint");
+    }
+
+    AlpsCheckpointRecord header;
+    std::map<int, AlpsCheckpointReader::Entry>::const_iterator pos;
+    for (pos = reader.entries().begin(); pos != reader.entries().end();
+         ++pos) {
+      header = pos->second.header;
+      long recordSize = append(out, header, reader.payload(pos->second));
+      newLive[pos->first] = std::make_pair(newBytes, recordSize);
+      newBytes += recordSize;
+    }
+
+    memset(&header, 0, sizeof(AlpsCheckpointRecord));
+    header.type = AlpsCheckpointRecordMark;
+    header.id = static_cast<int>(newLive.size());
+    header.aux = reader.getNextIndex();
+    newBytes += append(out, header, NULL);
+
+    if (fclose(out) != 0) {
+      throw CoinError("Failed to write checkpoint file",
+                      "compact", "AlpsCheckpoint");
+    }
+  }
+
+#if defined(_WIN32) || defined(_MSC_VER)
+  // rename() does not replace an existing file on Windows.
+  ::remove(fileName_.c_str());
+#endif
+  if (rename(tempName.c_str(), fileName_.c_str()) != 0) {
+    throw CoinError("Failed to replace checkpoint file",
+                    "compact", "AlpsCheckpoint");
+  }
+
+  live_.swap(newLive);
+  liveBytes_ = newBytes - static_cast<long>(sizeof(AlpsCheckpointRecord));
+  logBytes_ = newBytes;
+  ++numCompactions_;
+
+  openAppend();
+}
+
+//#############################################################################
@@ -0,0 +1,213 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+#ifndef AlpsCheckpoint_h_
+#define AlpsCheckpoint_h_
+
+#include "AlpsConfig.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "CoinError.hpp"
+
+#include "Alps.h"
+#include "AlpsEncoded.h"
+#include "AlpsKnowledge.h"
+#include "AlpsMappedFile.h"
+
+//#############################################################################
+
+/** Types of the records in a checkpoint log. */
+enum AlpsCheckpointRecordType {
+  /** An encoded subtree. Replaces any earlier record with the same id. */
+  AlpsCheckpointRecordSubTree = 1,
+  /** An encoded solution. Replaces any earlier record with the same id. */
+  AlpsCheckpointRecordSolution,
+  /** The knowledge with this id no longer exists. */
+  AlpsCheckpointRecordRemove,
+  /** End of a checkpoint. Records after the last mark are ignored. */
+  AlpsCheckpointRecordMark
+};
+
+/** The fixed size header preceding every record in a checkpoint log.
+    Payloads are padded to a multiple of 8 bytes so that headers stay
+    aligned when the log is memory mapped. */
+struct AlpsCheckpointRecord {
+  /** Always ALPS_CHECKPOINT_MAGIC, used to detect torn writes. */
+  int magic;
+  /** One of AlpsCheckpointRecordType. */
+  int type;
+  /** Knowledge id, or the number of live records for a mark. */
+  int id;
+  /** Knowledge type of the payload (AlpsKnowledgeType). */
+  int knowledgeType;
+  /** Quality of the knowledge when it was written. */
+  double quality;
+  /** Size of the payload in bytes (without padding). */
+  int size;
+  /** Unused. */
+  int reserved;
+  /** Next node index for a mark, zero otherwise. */
+  AlpsNodeIndex_t aux;
+};
+
+#define ALPS_CHECKPOINT_MAGIC 0x41435033 /* "ACP3" */
+
+//#############################################################################
+
+/** Memory mapped, read-only view of a checkpoint log. Only the record
+    headers are scanned when the log is opened; payloads are touched only
+    when the corresponding knowledge is restored. */
+class ALPSLIB_EXPORT AlpsCheckpointReader {
+
+ public:
+
+  /** Location and header of the latest committed record of a knowledge. */
+  struct Entry {
+    long offset;
+    AlpsCheckpointRecord header;
+  };
+
+ private:
+
+  /** The mapped log. */
+  AlpsMappedFile file_;
+  /** Length of the prefix that ends with the last mark. */
+  long committedLength_;
+  /** Next node index stored in the last mark. */
+  AlpsNodeIndex_t nextIndex_;
+  /** Latest committed record of each live knowledge, keyed by id. */
+  std::map<int, Entry> entries_;
+
+  /** Scan record headers and build entries_. */
+  void scan();
+
+  AlpsCheckpointReader(const AlpsCheckpointReader&);
+  AlpsCheckpointReader& operator=(const AlpsCheckpointReader&);
+
+ public:
+  /** Map the given log. A missing or empty file yields an empty reader. */
+  AlpsCheckpointReader(const std::string& fileName);
+
+  /** Get the live records keyed by id. */
+  const std::map<int, Entry>& entries() const { return entries_; }
+  /** Get the next node index stored in the last mark. */
+  AlpsNodeIndex_t getNextIndex() const { return nextIndex_; }
+  /** Get the length of the committed part of the log. */
+  long getCommittedLength() const { return committedLength_; }
+  /** Get the length of the log. */
+  long getLength() const { return file_.length(); }
+  /** Get a pointer to the payload of an entry. */
+  const char* payload(const Entry& entry) const {
+    return file_.data() + entry.offset + sizeof(AlpsCheckpointRecord);
+  }
+  /** Copy the payload of an entry into a new encoded object. The caller
+      owns the returned object. */
+  AlpsEncoded* encoded(const Entry& entry) const;
+};
+
+//#############################################################################
+
+/** An append-only log of the subtrees and solutions of a search. Each
+    checkpoint appends only the knowledge that changed since the previous
+    one, followed by a mark. When the log grows beyond
+    <code>compactFactor</code> times the size of the live records, it is
+    rewritten to contain only the live records. */
+class ALPSLIB_EXPORT AlpsCheckpoint {
+
+ private:
+
+  /** The log file. */
+  std::string fileName_;
+  /** The log opened for appending. */
+  FILE* file_;
+  /** Compact when log size exceeds this factor times the live size. */
+  double compactFactor_;
+  /** Current length of the log. */
+  long logBytes_;
+  /** Bytes occupied by live records. */
+  long liveBytes_;
+  /** Next unused knowledge id. */
+  int nextId_;
+  /** Next node index of the last mark. */
+  AlpsNodeIndex_t nextIndex_;
+  /** Number of checkpoints committed by this process. */
+  int numCommits_;
+  /** Number of compactions done by this process. */
+  int numCompactions_;
+  /** Offset and record size of each live knowledge, keyed by id. */
+  std::map<int, std::pair<long, long> > live_;
+
+  /** Write a record with the given payload to the given file and return
+      the number of bytes written. */
+  long append(FILE* out, AlpsCheckpointRecord& header, const char* payload);
+  /** Open the log for appending. */
+  void openAppend();
+
+  AlpsCheckpoint(const AlpsCheckpoint&);
+  AlpsCheckpoint& operator=(const AlpsCheckpoint&);
+
+ public:
+  /** Open a checkpoint log. If <code>resume</code> is true, the committed
+      part of an existing log is kept, otherwise the log is truncated. */
+  AlpsCheckpoint(const std::string& fileName, bool resume,
+                 double compactFactor);
+  /** Close the log. */
+  ~AlpsCheckpoint();
+
+  /** Get a knowledge id that has not been used in this log. */
+  int newId() { return nextId_++; }
+
+  /** Append the given knowledge under the given id. */
+  void write(int id, const AlpsKnowledge* kl, double quality);
+
+  /** Append a record saying the knowledge with given id is gone. */
+  void remove(int id);
+
+  /** Finish a checkpoint: append a mark and flush. Compact the log
+      afterward if it grew too large. */
+  void commit(AlpsNodeIndex_t nextIndex);
+
+  /** Rewrite the log to contain only the live records. */
+  void compact();
+
+  /** Query whether a knowledge id is live. */
+  bool isLive(int id) const { return live_.find(id) != live_.end(); }
+
+  /** @name Query statistics */
+  //@{
+  const std::string& getFileName() const { return fileName_; }
+  long getLogBytes() const { return logBytes_; }
+  long getLiveBytes() const { return liveBytes_; }
+  int getNumLive() const { return static_cast<int>(live_.size()); }
+  int getNumCommits() const { return numCommits_; }
+  int getNumCompactions() const { return numCompactions_; }
+  //@}
+};
+
+#endif
@@ -317,6 +317,22 @@ class ALPSLIB_EXPORT AlpsEncoded {
         return *this;
     }
 
+    /** Skip an array of objects of type <code>T</code> written by
+        <code>writeRep(const T* const, const int)</code> without copying
+        it. */
+    template <class T> AlpsEncoded& skipRep() {
+        int length;
+#ifdef PARANOID
+        if (pos_ + sizeof(int) > size_) {
+            throw CoinError("Reading over the end of buffer.",
+                            "skipRep()", "AlpsEncoded");
+        }
+#endif
+        memcpy(&length, representation_ + pos_, sizeof(int));
+        pos_ += sizeof(int) + sizeof(T) * length;
+        return *this;
+    }
+
     /** Read a <code>std::string</code> in <code>repsentation_ </code>. */
     AlpsEncoded& writeRep(std::string& value){
         // must define here, 'cos in *_message.C we have only templated members
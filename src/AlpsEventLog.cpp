@@ -0,0 +1,73 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#include "AlpsEventLog.h"
+
+//#############################################################################
+
+AlpsEventLog::AlpsEventLog(const std::string& fileName,
+                           int rank,
+                           int bufferSize)
+  :
+  writer_(fileName),
+  bufferSize_(bufferSize),
+  rank_(rank),
+  startTime_(AlpsGetTimeOfDay()),
+  numRecords_(0)
+{
+  AlpsEventLogHeader header;
+  memset(&header, 0, sizeof(AlpsEventLogHeader));
+  header.magic = ALPS_EVENT_LOG_MAGIC;
+  header.recordSize = sizeof(AlpsEventRecord);
+  header.rank = rank_;
+  header.startTime = startTime_;
+  writer_.write(reinterpret_cast<const char*>(&header),
+                sizeof(AlpsEventLogHeader));
+
+  buffer_.reserve(bufferSize_);
+}
+
+//#############################################################################
+
+AlpsEventLog::~AlpsEventLog()
+{
+  flush();
+  writer_.close();
+}
+
+//#############################################################################
+
+void
+AlpsEventLog::flush()
+{
+  writer_.write(buffer_);
+  // The writer hands back whatever buffer it swapped out, which may be
+  // smaller than what we need.
+  buffer_.reserve(bufferSize_);
+}
+
+//#############################################################################
@@ -0,0 +1,172 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#ifndef AlpsEventLog_h_
+#define AlpsEventLog_h_
+
+#include "AlpsConfig.h"
+
+#include <cstring>
+#include <string>
+
+#include "Alps.h"
+#include "AlpsAsyncWriter.h"
+#include "AlpsTime.h"
+#include "AlpsTreeNode.h"
+
+//#############################################################################
+
+/** Events recorded in a search tree event log. */
+enum AlpsEventType {
+  /** A node was created by branching. */
+  AlpsEventCreate = 0,
+  /** A node was processed or branched on. */
+  AlpsEventProcess,
+  /** A dead node was removed from the tree. */
+  AlpsEventRemove,
+  /** An improving solution was found while processing a node. The quality
+      of the record is the value of the solution. */
+  AlpsEventSolution
+};
+
+/** The header at the start of an event log. */
+struct AlpsEventLogHeader {
+  /** Always ALPS_EVENT_LOG_MAGIC. */
+  int magic;
+  /** Size of each record, sizeof(AlpsEventRecord). */
+  int recordSize;
+  /** Rank of the process writing the log. */
+  int rank;
+  /** Unused. */
+  int reserved;
+  /** Time of day (seconds since the epoch) the log was opened. Record
+      times are relative to it. */
+  double startTime;
+};
+
+/** A fixed size record in an event log. */
+struct AlpsEventRecord {
+  /** Index of the node. */
+  AlpsNodeIndex_t index;
+  /** Index of the parent node, -1 for the root. */
+  AlpsNodeIndex_t parentIndex;
+  /** Depth of the node. */
+  int depth;
+  /** Rank of the process. */
+  int rank;
+  /** Quality of the node. */
+  double quality;
+  /** Seconds since the log was opened. */
+  double time;
+  /** One of AlpsEventType. */
+  signed char event;
+  /** Status before the event (AlpsNodeStatus), -1 for a new node. */
+  signed char fromStatus;
+  /** Status after the event (AlpsNodeStatus). */
+  signed char toStatus;
+  /** Unused. */
+  char reserved;
+  /** Seconds spent in AlpsTreeNode::process() for a process event, zero
+      otherwise. */
+  float duration;
+};
+
+#define ALPS_EVENT_LOG_MAGIC 0x41455632 /* "AEV2" */
+
+//#############################################################################
+
+/** A low overhead log of search tree events. Records are appended to an
+    in-memory buffer owned by the search thread; full buffers are handed
+    to a background writer. */
+class ALPSLIB_EXPORT AlpsEventLog {
+
+ private:
+
+  /** The background writer. */
+  AlpsAsyncWriter writer_;
+  /** Records not handed to the writer yet. */
+  std::string buffer_;
+  /** Hand the buffer to the writer when it reaches this size. */
+  std::string::size_type bufferSize_;
+  /** Rank stored in each record. */
+  int rank_;
+  /** Time of day the log was opened. */
+  double startTime_;
+  /** Number of records logged. */
+  long numRecords_;
+
+  AlpsEventLog(const AlpsEventLog&);
+  AlpsEventLog& operator=(const AlpsEventLog&);
+
+ public:
+  /** Truncate the given file and write the log header. Records are
+      buffered up to <code>bufferSize</code> bytes. */
+  AlpsEventLog(const std::string& fileName, int rank,
+               int bufferSize = 1 << 16);
+  /** Write the buffered records and close the file. */
+  ~AlpsEventLog();
+
+  /** Record an event. */
+  void record(AlpsEventType event, AlpsNodeIndex_t index,
+              AlpsNodeIndex_t parentIndex, int depth, double quality,
+              int fromStatus, int toStatus, double duration = 0.0) {
+    AlpsEventRecord rec;
+    rec.index = index;
+    rec.parentIndex = parentIndex;
+    rec.depth = depth;
+    rec.rank = rank_;
+    rec.quality = quality;
+    rec.time = AlpsGetTimeOfDay() - startTime_;
+    rec.event = static_cast<signed char>(event);
+    rec.fromStatus = static_cast<signed char>(fromStatus);
+    rec.toStatus = static_cast<signed char>(toStatus);
+    rec.reserved = 0;
+    rec.duration = static_cast<float>(duration);
+    buffer_.append(reinterpret_cast<const char*>(&rec),
+                   sizeof(AlpsEventRecord));
+    ++numRecords_;
+    if (buffer_.size() >= bufferSize_) {
+      flush();
+    }
+  }
+
+  /** Record an event on the given node. */
+  void record(AlpsEventType event, const AlpsTreeNode* node,
+              int fromStatus, int toStatus, double duration = 0.0) {
+    record(event, node->getIndex(), node->getParentIndex(),
+           node->getDepth(), node->getQuality(), fromStatus, toStatus,
+           duration);
+  }
+
+  /** Hand the buffered records to the background writer. */
+  void flush();
+
+  /** Get the number of records logged. */
+  long getNumRecords() const { return numRecords_; }
+};
+
+#endif
@@ -72,6 +72,19 @@ struct DeletePtrObject
         }
 };
 
+//#############################################################################
+/** Compute the 64-bit FNV-1a hash of a byte array. Used to identify
+    encoded knowledge by its content. */
+inline unsigned long long AlpsHashBytes(const char* data, long length)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (long i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 //#############################################################################
 /** Delay for the specified seconds. */
 inline void AlpsSleep(double sec)
@@ -40,7 +40,7 @@ AlpsKnowledgeBroker::AlpsKnowledgeBroker()
     workingSubTree_(0),
     needWorkingSubTree_(true),// Initially workingSubTree_ points to NULL
     nextIndex_(0),
-    maxIndex_(INT_MAX),
+    maxIndex_(INT64_MAX),
     solNum_(0),
     nodeProcessedNum_(0),
     nodeBranchedNum_(0),
@@ -62,7 +62,12 @@ AlpsKnowledgeBroker::AlpsKnowledgeBroker()
     nodeMemSize_(0),
     nodeProcessingTime_(ALPS_NODE_PROCESS_TIME), // Positive
     largeSize_(100000),
-    numNodeLog_(0)
+    numNodeLog_(0),
+    checkpoint_(0),
+    checkpointInterval_(ALPS_DBL_MAX),
+    lastCheckpointTime_(0.0),
+    solutionStream_(0),
+    eventLog_(0)
 {
     registerClass(AlpsKnowledgeTypeSubTree, new AlpsSubTree(this));
     handler_ = new CoinMessageHandler();
@@ -83,7 +88,7 @@ AlpsKnowledgeBroker::AlpsKnowledgeBroker(AlpsModel& model)
     workingSubTree_(0),
     needWorkingSubTree_(true),// Initially workingSubTree_ points to NULL
     nextIndex_(0),
-    maxIndex_(INT_MAX),
+    maxIndex_(INT64_MAX),
     solNum_(0),
     nodeProcessedNum_(0),
     nodeBranchedNum_(0),
@@ -105,7 +110,12 @@ AlpsKnowledgeBroker::AlpsKnowledgeBroker(AlpsModel& model)
     nodeMemSize_(0),
     nodeProcessingTime_(ALPS_NODE_PROCESS_TIME), // Positive
     largeSize_(100000),
-    numNodeLog_(0)
+    numNodeLog_(0),
+    checkpoint_(0),
+    checkpointInterval_(ALPS_DBL_MAX),
+    lastCheckpointTime_(0.0),
+    solutionStream_(0),
+    eventLog_(0)
 {
     registerClass(AlpsKnowledgeTypeSubTree, new AlpsSubTree(this));
     handler_ = new CoinMessageHandler();
@@ -159,6 +169,18 @@ AlpsKnowledgeBroker:: ~AlpsKnowledgeBroker()
         delete  handler_;
         handler_ = 0;
     }
+    if (checkpoint_) {
+        delete checkpoint_;
+        checkpoint_ = 0;
+    }
+    if (solutionStream_) {
+        delete solutionStream_;
+        solutionStream_ = 0;
+    }
+    if (eventLog_) {
+        delete eventLog_;
+        eventLog_ = 0;
+    }
 }
 
 //#############################################################################
@@ -338,3 +360,231 @@ AlpsKnowledgeBroker::setupKnowledgePools()
 }
 
 //#############################################################################
+
+/** Mark the open nodes of a subtree so that they are put into the node pool
+    when the subtree is decoded, or clear the marks. */
+static void
+markOpenNodes(AlpsSubTree* st, int mark)
+{
+    std::vector<AlpsTreeNode*> nodes =
+        st->nodePool()->getCandidateList().getContainer();
+    std::vector<AlpsTreeNode*> diveNodes =
+        st->diveNodePool()->getCandidateList().getContainer();
+    nodes.insert(nodes.end(), diveNodes.begin(), diveNodes.end());
+
+    AlpsTreeNode* active = st->activeNode();
+    if (active && active->getStatus() != AlpsNodeStatusFathomed &&
+        active->getStatus() != AlpsNodeStatusBranched) {
+        nodes.push_back(active);
+    }
+
+    std::vector<AlpsTreeNode*>::iterator pos;
+    for (pos = nodes.begin(); pos != nodes.end(); ++pos) {
+        (*pos)->setSentMark(mark);
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBroker::setupCheckpoint(const std::string& fileName,
+                                     bool restart)
+{
+    const double compactFactor =
+        model_->AlpsPar()->entry(AlpsParams::checkpointCompactFactor);
+
+    checkpointInterval_ =
+        model_->AlpsPar()->entry(AlpsParams::checkpointInterval);
+    lastCheckpointTime_ = AlpsGetTimeOfDay();
+
+    if (checkpoint_) {
+        delete checkpoint_;
+    }
+    checkpoint_ = new AlpsCheckpoint(fileName, restart, compactFactor);
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBroker::setupSolutionStream(const std::string& fileName)
+{
+    const int format =
+        model_->AlpsPar()->entry(AlpsParams::solutionStreamFormat);
+
+    if (solutionStream_) {
+        delete solutionStream_;
+    }
+    solutionStream_ = new AlpsSolutionStream(fileName, format);
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBroker::recordSolution(AlpsSolution* sol, double value)
+{
+    AlpsNodeIndex_t index = sol->getIndex();
+    AlpsNodeIndex_t parentIndex = -1;
+    int depth = sol->getDepth();
+
+    if (index < 0 && workingSubTree_ && workingSubTree_->activeNode()) {
+        index = workingSubTree_->activeNode()->getIndex();
+        parentIndex = workingSubTree_->activeNode()->getParentIndex();
+        depth = workingSubTree_->activeNode()->getDepth();
+    }
+
+    if (solutionStream_) {
+        solutionStream_->write(sol, value, timer_.getTime(), index, depth,
+                               getProcRank());
+    }
+    if (eventLog_) {
+        eventLog_->record(AlpsEventSolution, index, parentIndex, depth,
+                          value, -1, -1);
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBroker::setupEventLog(const std::string& fileName)
+{
+    if (eventLog_) {
+        delete eventLog_;
+    }
+    eventLog_ = new AlpsEventLog(fileName, getProcRank());
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBroker::checkpoint()
+{
+    if (checkpoint_ == NULL) {
+        return;
+    }
+
+    //------------------------------------------------------
+    // Subtrees: log the ones that changed, remove the ones that are gone.
+    //------------------------------------------------------
+
+    std::vector<AlpsSubTree*> subTreeVec =
+        subTreePool_->getSubTreeList().getContainer();
+    if (workingSubTree_) {
+        subTreeVec.push_back(workingSubTree_);
+    }
+
+    std::set<int> subTreeIds;
+    std::set<int>::iterator idPos;
+    std::vector<AlpsSubTree*>::iterator pos;
+
+    for (pos = subTreeVec.begin(); pos != subTreeVec.end(); ++pos) {
+        AlpsSubTree* st = *pos;
+        if (st->getRoot() == NULL || st->getNumNodes() == 0) {
+            continue;
+        }
+        if (st->getCheckpointId() < 0) {
+            st->setCheckpointId(checkpoint_->newId());
+        }
+        subTreeIds.insert(st->getCheckpointId());
+        if (st->getCheckpointDirty() ||
+            !checkpoint_->isLive(st->getCheckpointId())) {
+            markOpenNodes(st, 2);
+            checkpoint_->write(st->getCheckpointId(), st, st->getQuality());
+            markOpenNodes(st, 0);
+            st->setCheckpointDirty(false);
+        }
+    }
+
+    for (idPos = checkpointSubTrees_.begin();
+         idPos != checkpointSubTrees_.end(); ++idPos) {
+        if (subTreeIds.find(*idPos) == subTreeIds.end()) {
+            checkpoint_->remove(*idPos);
+        }
+    }
+    checkpointSubTrees_.swap(subTreeIds);
+
+    //------------------------------------------------------
+    // Solutions: log the new ones, remove the ones pushed out of the pool.
+    //------------------------------------------------------
+
+    std::vector<std::pair<AlpsKnowledge*, double> > sols;
+    solPool_->getAllKnowledges(sols);
+
+    std::map<std::pair<double, AlpsNodeIndex_t>, int> solIds;
+    std::map<std::pair<double, AlpsNodeIndex_t>, int>::iterator solPos;
+    std::vector<std::pair<AlpsKnowledge*, double> >::iterator sPos;
+
+    for (sPos = sols.begin(); sPos != sols.end(); ++sPos) {
+        AlpsSolution* sol = dynamic_cast<AlpsSolution*>(sPos->first);
+        std::pair<double, AlpsNodeIndex_t> key(sPos->second, sol->getIndex());
+        solPos = checkpointSolutions_.find(key);
+        if (solPos != checkpointSolutions_.end()) {
+            solIds[key] = solPos->second;
+        }
+        else if (solIds.find(key) == solIds.end()) {
+            int id = checkpoint_->newId();
+            checkpoint_->write(id, sol, sPos->second);
+            solIds[key] = id;
+        }
+    }
+
+    for (solPos = checkpointSolutions_.begin();
+         solPos != checkpointSolutions_.end(); ++solPos) {
+        if (solIds.find(solPos->first) == solIds.end()) {
+            checkpoint_->remove(solPos->second);
+        }
+    }
+    checkpointSolutions_.swap(solIds);
+
+    checkpoint_->commit(nextIndex_);
+    lastCheckpointTime_ = AlpsGetTimeOfDay();
+}
+
+//#############################################################################
+
+int
+AlpsKnowledgeBroker::restoreCheckpoint()
+{
+    if (checkpoint_ == NULL) {
+        return 0;
+    }
+
+    int numSubTrees = 0;
+
+    AlpsCheckpointReader reader(checkpoint_->getFileName());
+    std::map<int, AlpsCheckpointReader::Entry>::const_iterator pos;
+
+    for (pos = reader.entries().begin(); pos != reader.entries().end();
+         ++pos) {
+        const AlpsCheckpointRecord& header = pos->second.header;
+        AlpsEncoded* encoded = reader.encoded(pos->second);
+
+        if (header.type == AlpsCheckpointRecordSubTree) {
+            AlpsSubTree* st = dynamic_cast<AlpsSubTree*>
+                (decoderObject(AlpsKnowledgeTypeSubTree)->decode(*encoded));
+            st->calculateQuality();
+            st->setCheckpointId(pos->first);
+            st->setCheckpointDirty(false);
+            subTreePool_->addKnowledge(st, st->getQuality());
+            checkpointSubTrees_.insert(pos->first);
+            ++numSubTrees;
+        }
+        else {
+            AlpsSolution* sol = dynamic_cast<AlpsSolution*>
+                (decoderObject(AlpsKnowledgeTypeSolution)->decode(*encoded));
+            addKnowledge(AlpsKnowledgeTypeSolution, sol, header.quality);
+            checkpointSolutions_[std::make_pair(header.quality,
+                                                sol->getIndex())] =
+                pos->first;
+        }
+
+        delete encoded;
+    }
+
+    if (reader.getNextIndex() > nextIndex_) {
+        nextIndex_ = reader.getNextIndex();
+    }
+
+    return numSubTrees;
+}
+
+//#############################################################################
@@ -32,17 +32,21 @@
 #include <cmath>
 #include <iosfwd>
 #include <map>
+#include <set>
 #include <string>
 
 #include "CoinMessageHandler.hpp"
 
 #include "AlpsSearchStrategy.h"
+#include "AlpsCheckpoint.h"
 #include "AlpsEnumProcessT.h"
+#include "AlpsEventLog.h"
 #include "AlpsKnowledge.h"
 #include "AlpsKnowledgePool.h"
 #include "AlpsMessage.h"
 #include "AlpsParams.h"
 #include "AlpsSolutionPool.h"
+#include "AlpsSolutionStream.h"
 #include "AlpsSubTree.h"
 #include "AlpsSubTreePool.h"
 #include "AlpsModel.h"
@@ -163,6 +167,28 @@ protected:
   /** Times that node log is printed. */
   int numNodeLog_;
 
+  /// @name Checkpointing
+  //@{
+  /** The checkpoint log. NULL if checkpointing is disabled. */
+  AlpsCheckpoint *checkpoint_;
+  /** The time period (sec) between two checkpoints. */
+  double checkpointInterval_;
+  /** Wall clock time of the last checkpoint. */
+  double lastCheckpointTime_;
+  /** Ids of the subtrees stored in the last checkpoint. */
+  std::set<int> checkpointSubTrees_;
+  /** Ids of the solutions stored in the last checkpoint, keyed by
+      quality and node index. */
+  std::map<std::pair<double, AlpsNodeIndex_t>, int> checkpointSolutions_;
+  //@}
+
+  /** Stream to which improving solutions are written as they are found.
+      NULL if disabled. */
+  AlpsSolutionStream *solutionStream_;
+
+  /** Log of search tree events. NULL if disabled. */
+  AlpsEventLog *eventLog_;
+
 public:
   ///@name Constructor and Destructor.
   //@{
@@ -237,6 +263,45 @@ public:
   }
   //@}
 
+  /// @name Checkpointing
+  //@{
+  /** Open the checkpoint log with given name. If <code>restart</code> is
+      true, the committed part of an existing log is kept, otherwise the
+      log is truncated. Other checkpointing settings are read from the Alps
+      parameters. */
+  void setupCheckpoint(const std::string& fileName, bool restart);
+  /** Query whether a checkpoint should be taken now. */
+  bool checkpointDue() const {
+    return (checkpoint_ != NULL && phase_ == AlpsPhaseSearch &&
+            AlpsGetTimeOfDay() - lastCheckpointTime_ > checkpointInterval_);
+  }
+  /** Append the subtrees and solutions that changed since the last
+      checkpoint to the checkpoint log. */
+  void checkpoint();
+  /** Load the subtrees and solutions stored in the checkpoint log into the
+      knowledge pools. Return the number of subtrees restored. */
+  int restoreCheckpoint();
+  //@}
+
+  /// @name Solution streaming
+  //@{
+  /** Open the solution stream with given name. The format is read from
+      the Alps parameters. */
+  void setupSolutionStream(const std::string& fileName);
+  /** Write the given improving solution to the solution stream and the
+      event log, whichever are open. The index and depth of the node being
+      processed are used if the solution does not carry its own. */
+  void recordSolution(AlpsSolution* sol, double value);
+  //@}
+
+  /// @name Search tree event log
+  //@{
+  /** Open the event log with given name. */
+  void setupEventLog(const std::string& fileName);
+  /** Get the event log. NULL if disabled. */
+  AlpsEventLog* getEventLog() { return eventLog_; }
+  //@}
+
   /// @name Get/set phase.
   //@{
   AlpsPhase getPhase() { return phase_; }
@@ -365,6 +430,12 @@ public:
     if(kt == AlpsKnowledgeTypeSolution || kt == AlpsKnowledgeTypeSubTree) {
       //todo(aykut) is this the right place to do this?
       //kl->setType(kt);
+      if ((solutionStream_ || eventLog_) &&
+          kt == AlpsKnowledgeTypeSolution &&
+          (!solPool_->hasKnowledge() ||
+           value < solPool_->getBestKnowledge().second)) {
+        recordSolution(dynamic_cast<AlpsSolution*>(kl), value);
+      }
       getKnowledgePool(kt)->addKnowledge(kl, value);
     }
     else {
@@ -389,6 +460,10 @@ public:
   int getNumNodesDiscarded() const {
     return nodeDiscardedNum_;
   }
+  /** Add to the number of nodes discarded by this process. */
+  void addNumNodesDiscarded(int num) {
+    nodeDiscardedNum_ += num;
+  }
   /** Query the number of node in the queue that are pregnant. */
   int getNumNodesPartial() const {
     return nodePartialNum_;
@@ -445,6 +520,16 @@ public:
       it stores.*/
   virtual double getIncumbentValue() const = 0;
 
+  /** Return true if an open node of the given quality and status cannot
+      lead to a solution better than the incumbent, so that a receiver can
+      drop it without decoding it. */
+  bool isDominated(double quality, AlpsNodeStatus status) const {
+    return (status == AlpsNodeStatusCandidate ||
+            status == AlpsNodeStatusEvaluated ||
+            status == AlpsNodeStatusPregnant) &&
+      quality < ALPS_OBJ_MAX_LESS && quality >= getIncumbentValue();
+  }
+
   /** The process (serial) / the master (parallel) queries the quality
       of the best solution that it knows. */
   virtual double getBestQuality() const = 0;
@@ -26,8 +26,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
 #include <exception>
+#include <string>
+#include <vector>
 
 #include "CoinError.hpp"
 #include "CoinHelperFunctions.hpp"
@@ -35,22 +38,17 @@
 
 #include "AlpsHelperFunctions.h"
 #include "AlpsKnowledgeBrokerMPI.h"
+#include "AlpsMappedFile.h"
 #include "AlpsMessageTag.h"
 #include "AlpsModel.h"
 #include "AlpsNodePool.h"
+#include "AlpsTransportMPI.h"
 #include "AlpsTreeNode.h"
 
 using std::exception;
 
 //#############################################################################
 
-static int cluster2GlobalRank(int masterRank, int myHubRank, int clusterRank)
-{
-    return (myHubRank - masterRank + clusterRank);
-}
-
-//#############################################################################
-
 // Form binary tree to broadcast solutions.
 static int rankToSequence(const int incRank, const int rank)
 {
@@ -90,6 +88,23 @@ static int rightSequence(const int sequence, const int numProcesses)
 
 //#############################################################################
 
+// Names of the message tags in the order of AlpsMessageTag.
+static const char* msgTagNames[] = {
+    "ContOrTerm", "AskDonate", "AskDonateToHub", "AskHubShare",
+    "FinishInit", "HubLoad", "AskLoad", "AskPause", "AskTerminate", "Idle",
+    "Incumbent", "LoadInfo", "WorkerNeedWork", "Model", "Node", "Params",
+    "TermCheck", "HubCheckCluster", "HubPeriodCheck", "HubPeriodReport",
+    "HubStatus", "WorkerStatus", "HubTermStatus", "WorkerTermStatus",
+    "Size", "SubTreeByMaster", "SubTree", "NodeSize", "TellMasterRecv",
+    "TellHubRecv", "IndicesFromMaster", "WorkerAskIndices", "ForceTerm",
+    "MasterIncumbent", "HubIncumbent", "AskHubPause", "AskDonateToWorker",
+    "SubTreeByWorker", "IncumbentTwo", "ModelGenRampUp", "ModelGenSearch",
+    "HubFailFindDonor", "RampUpLoad", "RampUpDonate", "FinishInitHub",
+    "ModelChunk", "ErrorCode", "Envelope", "StealRequest"
+};
+
+//#############################################################################
+
 static int computeUnitNodes(int oldUnitNodes,
                             double nodeProcessingTime)
 {
@@ -255,9 +270,13 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
 
     //const bool clockType =
     //model_->AlpsPar()->entry(AlpsParams::clockType);
-    const bool interCB =
+    // Work stealing replaces the hierarchical balancing.
+    const bool workStealing =
+        (model_->AlpsPar()->entry(AlpsParams::dynamicBalanceScheme) ==
+         AlpsWorkStealing);
+    const bool interCB = !workStealing &&
         model_->AlpsPar()->entry(AlpsParams::interClusterBalance);
-    const bool intraCB =
+    const bool intraCB = !workStealing &&
         model_->AlpsPar()->entry(AlpsParams::intraClusterBalance);
 
     const int smallSize =
@@ -270,6 +289,9 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
     const double zeroLoad =
         model_->AlpsPar()->entry(AlpsParams::zeroLoad);
 
+    const bool decentralTerm =
+        model_->AlpsPar()->entry(AlpsParams::decentralTermination);
+
     masterBalancePeriod_ =
         model_->AlpsPar()->entry(AlpsParams::masterBalancePeriod);
     if (masterBalancePeriod_ > 0.0) {
@@ -357,6 +379,8 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
         }
     }
 
+    createSubTreeWindow();
+
     MPI_Barrier(MPI_COMM_WORLD); // Sync before rampup
 
     //======================================================
@@ -374,6 +398,10 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
     case AlpsSpiral:
         spiralMaster(root);
         break;
+    case AlpsRacing:
+        racingRampUp(root);
+        rootInitMaster(root);
+        break;
     default:
         throw CoinError("Unknown static balance scheme", "masterMain",
                         "AlpsKnowledgeBrokerMPI");
@@ -403,12 +431,7 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
             << globalRank_ <<  masterBalancePeriod_ << CoinMessageEol;
     }
 
-    MPI_Request request;
     MPI_Status status;
-    int flag;
-
-    MPI_Irecv(largeBuffer_, largeSize_, MPI_PACKED, MPI_ANY_SOURCE,
-              MPI_ANY_TAG, MPI_COMM_WORLD, &request);
 
     while (true) {
 
@@ -423,10 +446,9 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
         //std::cout << ", masterBalancePeriod_ = " << masterBalancePeriod_
         //        << std::endl;
 
-        while (elaspeTime < masterBalancePeriod_) {
-            MPI_Test(&request, &flag, &status);
-            if (flag) { // Receive a msg
-                processMessages(largeBuffer_, status, request);
+        while (elaspeTime < masterBalancePeriod_ * balancePeriodScale_) {
+            if (!processMessages(status)) {
+                flushMessages();
             }
             elaspeTime = masterTimer_.getTime();
             // std::cout << "***** elaspeTime = " << elaspeTime
@@ -434,6 +456,8 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
             //       << std::endl;
         }
 
+        readIncumbent();
+
         //**------------------------------------------------
         // Check if all workers in this cluster have reported their status.
         //**------------------------------------------------
@@ -457,7 +481,7 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
             allHubReported_ = true;
             // NOTE: The position of this hub is 0.
             hubReported_[0] = true;
-            for (i = 0; i < hubNum_; ++i) {
+            for (i = 0; i < static_cast<int>(childRanks_.size()); ++i) {
                 if ( hubReported_[i] != true ) {
                     allHubReported_ =  false;
                     break;
@@ -638,7 +662,8 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
         // If terminate check can be activated.
         //**------------------------------------------------
 
-        if ( allWorkerReported &&
+        if ( !decentralTerm &&
+             allWorkerReported &&
              allHubReported_ &&
              (systemWorkQuantity_ < zeroLoad ) &&
              (systemSendCount_ == systemRecvCount_) ) {
@@ -677,8 +702,7 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
             // Ask other hubs to do termination check.
             for (i = 0; i < hubNum_; ++i) {
                 if (hubRanks_[i] != globalRank_) {
-                    MPI_Send(smallBuffer_, 0, MPI_PACKED, hubRanks_[i],
-                             AlpsMsgAskHubPause, MPI_COMM_WORLD);
+                    postSend(hubRanks_[i], AlpsMsgAskHubPause, NULL, 0);
 #ifdef NF_DEBUG
                     std::cout << "Master["<< masterRank_ << "] ask hub["
                               << hubRanks_[i] << "] to do termination check."
@@ -689,14 +713,12 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
 
             // Ask master's workers to do termination check.
             for (i = 0; i < clusterSize_; ++i) {
-                //if (i != clusterRank_) {
-                if (i != globalRank_) {
+                if (i != clusterRank_) {
 #ifdef NF_DEBUG
                     std::cout << "Master["<< masterRank_ << "] ask its worker["
-                              << i << "] to do termination check."<< std::endl;
+                              << clusterRanks_[i] << "] to do termination check."<< std::endl;
 #endif
-                    MPI_Send(smallBuffer_, 0, MPI_PACKED, i,
-                             AlpsMsgAskPause, MPI_COMM_WORLD);
+                    postSend(clusterRanks_[i], AlpsMsgAskPause, NULL, 0);
                 }
             }
 
@@ -708,7 +730,9 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
             for(i = 1; i < clusterSize_; ++i) {
                 MPI_Irecv(smallBuffer_, smallSize, MPI_PACKED, MPI_ANY_SOURCE,
                           AlpsMsgWorkerTermStatus, clusterComm_, &termReq);
+                const double waitStart = profileClock();
                 MPI_Wait(&termReq, &termSta);
+                profileWait(AlpsMsgWorkerTermStatus, waitStart);
                 hubUpdateCluStatus(smallBuffer_, &termSta, clusterComm_);
             }
 
@@ -726,7 +750,9 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
             for(i = 1; i < hubNum_; ++i) {
                 MPI_Irecv(smallBuffer_, smallSize, MPI_PACKED, MPI_ANY_SOURCE,
                           AlpsMsgHubTermStatus, hubComm_, &termReq);
+                const double waitStart = profileClock();
                 MPI_Wait(&termReq, &termSta);
+                profileWait(AlpsMsgHubTermStatus, waitStart);
                 masterUpdateSysStatus(smallBuffer_, &termSta, hubComm_);
             }
 
@@ -871,6 +897,19 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
             }
         }
 
+        //**------------------------------------------------
+        // Or take part in decentralized termination detection.
+        //**------------------------------------------------
+
+        if (decentralTerm && testTermination()) {
+            if (msgLevel_ > 0) {
+                messageHandler()->message(ALPS_TERM_MASTER_INFORM, messages())
+                    << globalRank_ << "stop searching" << CoinMessageEol;
+            }
+            terminate = true;
+            break;  // Break *,  Master terminates
+        }
+
         //**------------------------------------------------
         // Master balances work load of hubs if
         // (1) not terminate,
@@ -887,7 +926,7 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
 
         if ( !terminate && !forceTerminate_ &&
              allHubReported_ && (masterDoBalance_ == 0) ) {
-            if (hubNum_ > 1 && interCB) {
+            if (childRanks_.size() > 1 && interCB) {
                 masterBalanceHubs();
                 ++masterCheckCount;
                 if (masterCheckCount % 10 == 0) {
@@ -918,21 +957,11 @@ AlpsKnowledgeBrokerMPI::masterMain(AlpsTreeNode* root)
                 }
             }
         }
-    }
 
-    //------------------------------------------------------
-    // Clean up before leaving.
-    //------------------------------------------------------
-
-    int cancelNum = 0;
-
-    MPI_Cancel(&request);
-    MPI_Wait(&request, &status);
-
-    MPI_Test_cancelled(&status, &flag);
-    if(flag) {  // Cancel succeeded
-        ++cancelNum;
+        // Adjust the balancing thresholds and period.
+        tuneBalance(0.0);
     }
+
 }
 
 //#############################################################################
@@ -967,10 +996,18 @@ AlpsKnowledgeBrokerMPI::hubMain()
         model_->AlpsPar()->entry(AlpsParams::staticBalanceScheme);
     const int smallSize =
         model_->AlpsPar()->entry(AlpsParams::smallSize);
-    const bool intraCB =
+    // Work stealing replaces the hierarchical balancing.
+    const bool workStealing =
+        (model_->AlpsPar()->entry(AlpsParams::dynamicBalanceScheme) ==
+         AlpsWorkStealing);
+    const bool interCB = !workStealing &&
+        model_->AlpsPar()->entry(AlpsParams::interClusterBalance);
+    const bool intraCB = !workStealing &&
         model_->AlpsPar()->entry(AlpsParams::intraClusterBalance);
     const double zeroLoad =
         model_->AlpsPar()->entry(AlpsParams::zeroLoad);
+    const bool decentralTerm =
+        model_->AlpsPar()->entry(AlpsParams::decentralTermination);
     double unitTime =
         model_->AlpsPar()->entry(AlpsParams::unitWorkTime);
     if (unitTime <= 0.0) {
@@ -978,8 +1015,6 @@ AlpsKnowledgeBrokerMPI::hubMain()
         unitTime  = ALPS_DBL_MAX;
     }
 
-    double changeWorkThreshold = model_->AlpsPar()->
-        entry(AlpsParams::changeWorkThreshold);
 
     hubReportPeriod_ = model_->AlpsPar()->entry(AlpsParams::hubReportPeriod);
     if (hubReportPeriod_ > 0.0) {
@@ -1017,6 +1052,21 @@ AlpsKnowledgeBrokerMPI::hubMain()
     workerWorkQualities_[0] = workQuality_;
     workerWorkQuantities_[0] = workQuantity_ = 0.0;
 
+    // A sub-master keeps the status of the hubs in its group.
+    if (subMaster_) {
+        const int childNum = static_cast<int>(childRanks_.size());
+        hubNodeProcesseds_ = new int [childNum];
+        hubWorkQualities_ = new double [childNum];
+        hubWorkQuantities_ = new double [childNum];
+        hubReported_ = new bool [childNum];
+        for (i = 0; i < childNum; ++i) {
+            hubNodeProcesseds_[i] = 0;
+            hubWorkQualities_[i] = 0.0;
+            hubWorkQuantities_[i] = 0.0;
+            hubReported_[i] = false;
+        }
+    }
+
     //------------------------------------------------------
     // Recv tree node size and send it to my worker.
     // NOTE: master's rank is always 0 in hubComm_.
@@ -1037,6 +1087,8 @@ AlpsKnowledgeBrokerMPI::hubMain()
     largeBuffer2_ = new char [largeSize_];
     smallBuffer_ = new char [smallSize];
 
+    createSubTreeWindow();
+
     MPI_Barrier(MPI_COMM_WORLD); // Sync before rampup
 
     //======================================================
@@ -1054,6 +1106,10 @@ AlpsKnowledgeBrokerMPI::hubMain()
     case AlpsSpiral:
         spiralHub();
         break;
+    case AlpsRacing:
+        racingRampUp(NULL);
+        rootInitHub();
+        break;
     default:
         throw CoinError("Unknown static balance scheme", "hubMain",
                         "AlpsKnowledgeBrokerMPI");
@@ -1085,30 +1141,23 @@ AlpsKnowledgeBrokerMPI::hubMain()
             << globalRank_ << hubReportPeriod_ << CoinMessageEol;
     }
 
-    MPI_Request request;
-    int flag = 1;
-
-    MPI_Irecv(largeBuffer_, largeSize_, MPI_PACKED, MPI_ANY_SOURCE,
-              MPI_ANY_TAG, MPI_COMM_WORLD, &request);
-
     while (true) {
 
-        flag = 1;
-
         //**------------------------------------------------
         // Listen and process msg for a period.
         //**------------------------------------------------
 
         hubTimer_.start();
         elaspeTime = 0.0;
-        while (elaspeTime < hubReportPeriod_ ) {
-            MPI_Test(&request, &flag, &status);
-            if (flag) { // Received a msg
-              processMessages(largeBuffer_, status, request);
+        while (elaspeTime < hubReportPeriod_ * balancePeriodScale_) {
+            if (!processMessages(status)) {
+              flushMessages();
             }
             elaspeTime = hubTimer_.getTime();
         }
 
+        readIncumbent();
+
         //std::cout << "++++++ hubReportPeriod_ = "
         //    << hubReportPeriod_ << std::endl;
 
@@ -1212,7 +1261,7 @@ AlpsKnowledgeBrokerMPI::hubMain()
             updateWorkloadInfo();
 
             // Adjust workingSubTree_ if it 'much' worse than the best one.
-            changeWorkingSubTree(changeWorkThreshold);
+            changeWorkingSubTree(changeWorkThreshold_);
 
 #if 0
             std::cout << "******** HUB [" << globalRank_ << "]: "
@@ -1252,6 +1301,25 @@ AlpsKnowledgeBrokerMPI::hubMain()
 
         refreshClusterStatus();
 
+        //**------------------------------------------------
+        // A sub-master adds its cluster to the status of its group.
+        //**------------------------------------------------
+
+        if (subMaster_) {
+            if (!allHubReported_) {
+                allHubReported_ = true;
+                // NOTE: The position of this hub is 0.
+                hubReported_[0] = true;
+                for (i = 0; i < static_cast<int>(childRanks_.size()); ++i) {
+                    if (hubReported_[i] != true) {
+                        allHubReported_ = false;
+                        break;
+                    }
+                }
+            }
+            refreshSysStatus();
+        }
+
 #if 0
         std::cout << "HUB "<< globalRank_
                   << ": clusterWorkQuality_  = " << clusterWorkQuality_
@@ -1269,7 +1337,8 @@ AlpsKnowledgeBrokerMPI::hubMain()
         // block report.
         //**------------------------------------------------
 
-        if ((clusterSendCount_ || clusterRecvCount_ || !blockHubReport_)) {
+        if ((clusterSendCount_ || clusterRecvCount_ || !blockHubReport_ ||
+             (subMaster_ && (systemSendCount_ || systemRecvCount_)))) {
             //&& reportCount == hubReportFreqency) {
 
             //reportCount = 0;
@@ -1279,9 +1348,13 @@ AlpsKnowledgeBrokerMPI::hubMain()
                 updateWorkloadInfo();
             }
             refreshClusterStatus();  // IMPORTANT: report latest state
+            if (subMaster_) {
+                refreshSysStatus();
+            }
             hubReportStatus(AlpsMsgHubPeriodReport, MPI_COMM_WORLD);
 
-            if (clusterWorkQuantity_ < zeroLoad) {
+            if ((subMaster_ ? systemWorkQuantity_ : clusterWorkQuantity_) <
+                zeroLoad) {
                 blockHubReport_ = true;
 #ifdef NF_DEBUG_MORE
                 std::cout << "HUB[" << globalRank_ << "]: blockHubReport"
@@ -1306,9 +1379,8 @@ AlpsKnowledgeBrokerMPI::hubMain()
             // Ask hub's workers to check termination
             for (i = 0; i < clusterSize_; ++i) {
                 if (i != clusterRank_) {
-                    int workRank = globalRank_ - masterRank_ + i;
-                    MPI_Send(smallBuffer_, 0, MPI_PACKED, workRank,
-                             AlpsMsgAskPause, MPI_COMM_WORLD);
+                    int workRank = clusterRanks_[i];
+                    postSend(workRank, AlpsMsgAskPause, NULL, 0);
 #ifdef NF_DEBUG
                     std::cout << "HUB[" << globalRank_ << "]: ask its worker "
                               << workRank << " to do TERM check."
@@ -1324,7 +1396,9 @@ AlpsKnowledgeBrokerMPI::hubMain()
             for(i = 1; i < clusterSize_; ++i) {
                 MPI_Irecv(smallBuffer_, smallSize, MPI_PACKED, MPI_ANY_SOURCE,
                           AlpsMsgWorkerTermStatus, clusterComm_, &termReq);
+                const double waitStart = profileClock();
                 MPI_Wait(&termReq, &termSta);
+                profileWait(AlpsMsgWorkerTermStatus, waitStart);
                 hubUpdateCluStatus(smallBuffer_, &termSta, clusterComm_);
             }
 
@@ -1347,7 +1421,9 @@ AlpsKnowledgeBrokerMPI::hubMain()
             // NOTE: master's rank is always 0 in hubComm_.
             MPI_Irecv(&reply, 1, MPI_CHAR, 0, AlpsMsgContOrTerm, hubComm_,
                       &termReq);
+            const double waitStart = profileClock();
             MPI_Wait(&termReq, &termSta);
+            profileWait(AlpsMsgContOrTerm, waitStart);
 
 #ifdef NF_DEBUG
             std::cout << "HUB[" << globalRank_ << "]: received TERM instruction "
@@ -1398,6 +1474,19 @@ AlpsKnowledgeBrokerMPI::hubMain()
             }
         }
 
+        //**------------------------------------------------
+        // Or take part in decentralized termination detection.
+        //**------------------------------------------------
+
+        if (decentralTerm && testTermination()) {
+            if (hubMsgLevel_ > 0) {
+                messageHandler()->message(ALPS_TERM_HUB_INFORM, messages())
+                    << globalRank_<< "exit" << CoinMessageEol;
+            }
+            terminate = true;
+            break;    // Break * and terminate
+        }
+
         //**------------------------------------------------
         // Hub balances the workload of its workers if
         // (1) not terminate,
@@ -1420,20 +1509,22 @@ AlpsKnowledgeBrokerMPI::hubMain()
             }
         }
 
-    } // EOF while
+        //**------------------------------------------------
+        // A sub-master balances the workload of the hubs in its group
+        // the same way the master balances the groups.
+        //**------------------------------------------------
 
+        if ( subMaster_ && !terminate && !forceTerminate_ &&
+             allHubReported_ && (masterDoBalance_ == 0) ) {
+            if (childRanks_.size() > 1 && interCB) {
+                masterBalanceHubs();
+            }
+        }
 
-    //------------------------------------------------------
-    // Clean up before leaving.
-    //------------------------------------------------------
+        // Adjust the balancing thresholds and period.
+        tuneBalance(0.0);
 
-    int cancelNum = 0;
-    MPI_Cancel(&request);
-    MPI_Wait(&request, &status);
-    MPI_Test_cancelled(&status, &flag);
-    if(flag) {  // Cancel succeeded
-        ++cancelNum;
-    }
+    } // EOF while
 }
 
 //#############################################################################
@@ -1478,11 +1569,13 @@ AlpsKnowledgeBrokerMPI::workerMain()
         model_->AlpsPar()->entry(AlpsParams::workerMsgLevel);
     const double zeroLoad =
         model_->AlpsPar()->entry(AlpsParams::zeroLoad);
-    double changeWorkThreshold =
-        model_->AlpsPar()->entry(AlpsParams::changeWorkThreshold);
-    const double needWorkThreshold =
-        model_->AlpsPar()->entry(AlpsParams::needWorkThreshold);
-    const bool intraCB =
+    const bool decentralTerm =
+        model_->AlpsPar()->entry(AlpsParams::decentralTermination);
+    // Work stealing replaces the hierarchical balancing.
+    const bool workStealing =
+        (model_->AlpsPar()->entry(AlpsParams::dynamicBalanceScheme) ==
+         AlpsWorkStealing);
+    const bool intraCB = !workStealing &&
         model_->AlpsPar()->entry(AlpsParams::intraClusterBalance);
     double unitTime  =
         model_->AlpsPar()->entry(AlpsParams::unitWorkTime);
@@ -1514,8 +1607,16 @@ AlpsKnowledgeBrokerMPI::workerMain()
     largeBuffer2_ = new char [largeSize_];
     smallBuffer_ = new char [smallSize];
 
+    createSubTreeWindow();
+
     MPI_Barrier(MPI_COMM_WORLD); // Sync before rampup
 
+    if (deferSetupSelf_) {
+        // Overlaps with the master's ramp-up.
+        model_->setupSelf();
+        deferSetupSelf_ = false;
+    }
+
     //======================================================
     // Worker's Ramp-up.
     //======================================================
@@ -1530,6 +1631,10 @@ AlpsKnowledgeBrokerMPI::workerMain()
     case AlpsSpiral:
         spiralWorker();
         break;
+    case AlpsRacing:
+        racingRampUp(NULL);
+        rootInitWorker();
+        break;
     default:
         throw CoinError("Unknown static balance scheme", "workerMain",
                         "AlpsKnowledgeBrokerMPI");
@@ -1555,12 +1660,6 @@ AlpsKnowledgeBrokerMPI::workerMain()
     // (3) Report status or check termination.
     //------------------------------------------------------
 
-    MPI_Request request;
-    int flag;
-
-    MPI_Irecv(largeBuffer_, largeSize_, MPI_PACKED, MPI_ANY_SOURCE,
-              MPI_ANY_TAG, MPI_COMM_WORLD, &request);
-
     while (true) {
 
         blockTermCheck_ = true;
@@ -1571,16 +1670,17 @@ AlpsKnowledgeBrokerMPI::workerMain()
 
         msgTimer.start();
         while (true) {
-            MPI_Test(&request, &flag, &status);
-            if (flag) { // Receive a msg
+            if (processMessages(status)) { // Received a msg
                 allMsgReceived = false;
-                processMessages(largeBuffer_, status, request);
             }
             else {
                 allMsgReceived = true;
                 break;
             }
         }
+        readIncumbent();
+        // Forwarded knowledge should not wait for a unit of work.
+        flushMessages();
         msgTime_ += msgTimer.getTime();
 
         //**------------------------------------------------
@@ -1607,14 +1707,6 @@ AlpsKnowledgeBrokerMPI::workerMain()
 
             bool betterSolution = false;
 
-            // Check whether need ask for node index before doing work
-            if (!haltSearch_) {
-                if (getMaxNodeIndex() - getNextNodeIndex() < (unitWorkNodes_ + 5)) {
-                    workerAskIndices();
-                    haltSearch_ = true;
-                }
-            }
-
             if ( !haltSearch_ &&
                  (workingSubTree_ || hasKnowledge(AlpsKnowledgeTypeSubTree))) {
                 if(isIdle) {
@@ -1669,7 +1761,7 @@ AlpsKnowledgeBrokerMPI::workerMain()
                 }
 
                 // Adjust workingSubTree_ if it 'much' worse than the best one
-                changeWorkingSubTree(changeWorkThreshold);
+                changeWorkingSubTree(changeWorkThreshold_);
 
                 // Print tree size
                 if ( (msgLevel_ == 1) &&
@@ -1692,6 +1784,10 @@ AlpsKnowledgeBrokerMPI::workerMain()
                     workerTimer_.start();
                     isIdle = true;
                 }
+                if (workStealing && !haltSearch_ && !forceTerminate_ &&
+                    !stealPending_ && AlpsGetTimeOfDay() >= stealNextTime_) {
+                    stealWork();
+                }
             }
 
             // If has better solution, check whether need to send it
@@ -1736,13 +1832,13 @@ AlpsKnowledgeBrokerMPI::workerMain()
                     blockWorkerReport_ = true;
                 }
                 if ( intraCB && !forceTerminate_ &&
-                     (workQuantity_ < needWorkThreshold) &&
+                     (workQuantity_ < needWorkThreshold_) &&
                      (blockAskForWork_ == false) ) {
 
                     ++(psStats_.workerAsk_);
 
-                    MPI_Send(tempBuffer, 0, MPI_PACKED, myHubRank_,
-                             AlpsMsgWorkerNeedWork, MPI_COMM_WORLD);
+                    queueMessage(myHubRank_, AlpsMsgWorkerNeedWork,
+                                 tempBuffer, 0);
                     incSendCount("workerAskForWork");
                     blockAskForWork_ = true;
                 }
@@ -1753,6 +1849,25 @@ AlpsKnowledgeBrokerMPI::workerMain()
                           << workQuantity_ << std::endl;
 #endif
             }
+
+            // Adjust the thresholds for asking for and changing work.
+            tuneBalance(isIdle ? idleTime_ + workerTimer_.getTime() :
+                        idleTime_);
+
+            // One message per destination for this round.
+            flushMessages();
+
+            // Take part in decentralized termination detection. Done after
+            // reporting so that no counted message is sent while idle.
+            if (decentralTerm && testTermination()) {
+                rampDownTime_ = workerTimer_.getTime();
+                terminate = true;
+                if (workerMsgLevel > 0) {
+                    messageHandler()->message(ALPS_TERM_WORKER_INFORM, messages())
+                        << globalRank_ << "exit" << CoinMessageEol;
+                }
+                break;  // Break * and terminate
+            }
         }
         else { /* Do termination check. */
 #if 0
@@ -1775,7 +1890,9 @@ AlpsKnowledgeBrokerMPI::workerMain()
             MPI_Status termSta;
             MPI_Irecv(&reply, 1, MPI_CHAR, masterRank_, AlpsMsgContOrTerm,
                       clusterComm_, &termReq);
+            const double waitStart = profileClock();
             MPI_Wait(&termReq, &termSta);
+            profileWait(AlpsMsgContOrTerm, waitStart);
 
             if(reply == 'T') {
                 terminate = true;
@@ -1802,27 +1919,108 @@ AlpsKnowledgeBrokerMPI::workerMain()
     //------------------------------------------------------
 
     updateNumNodesLeft();
+}
 
-    //------------------------------------------------------
-    // Cancel MPI_Irecv before leaving.
-    //------------------------------------------------------
+//#############################################################################
+
+// Every message sent through transport_ starts with the incumbent value and
+// rank of its sender, written by packPiggyback().
+static const int piggybackSize =
+    static_cast<int>(sizeof(double) + sizeof(int));
+
+// Bounds of the wait of an idle worker after an empty steal reply.
+static const double stealMinDelay = 0.001;
+static const double stealMaxDelay = 0.1;
+
+//#############################################################################
+
+// Receive and process a message if there is one.
+bool
+AlpsKnowledgeBrokerMPI::processMessages(MPI_Status &status)
+{
+    int source = 0;
+    int tag = 0;
+    int count = 0;
+
+    progressSends();
+
+    if (!transport_->probe(source, tag, count)) {
+        return false;
+    }
+
+    // Size the receive by the message; a donation larger than largeBuffer_
+    // gets a buffer of its own.
+    char* buffer = largeBuffer_;
+    if (count > largeSize_) {
+        buffer = new char [count];
+    }
+    transport_->receive(buffer);
+    ++tuneMsgCount_;
+
+    if (count < piggybackSize) {
+        throw CoinError("Message without incumbent", "processMessages",
+                        "AlpsKnowledgeBrokerMPI");
+    }
+    unpackPiggyback(buffer);
+    char* body = buffer + piggybackSize;
+    count -= piggybackSize;
+
+    // The handlers read the message's source, tag and size from status.
+    status.MPI_SOURCE = source;
+    status.MPI_TAG = tag;
+    MPI_Status_set_elements(&status, MPI_PACKED, count);
+
+    const double start = profileClock();
+    if (tag == AlpsMsgEnvelope) {
+        processEnvelope(body, status);
+    }
+    else {
+        processMessage(body, status);
+    }
+    profileRecv(tag, count, start);
+
+    if (buffer != largeBuffer_) {
+        delete [] buffer;
+    }
+    return true;
+}
+
+//#############################################################################
 
-    int cancelNum = 0;
-    MPI_Cancel(&request);
-    MPI_Wait(&request, &status);
-    MPI_Test_cancelled(&status, &flag);
-    if(flag) {  // Cancel succeeded
-        ++cancelNum;
+void
+AlpsKnowledgeBrokerMPI::processEnvelope(char *&bufLarge, MPI_Status &status)
+{
+    int count = 0;
+    int position = 0;
+    int header[2];
+    const int headerSize = static_cast<int>(sizeof(header));
+
+    MPI_Get_count(&status, MPI_PACKED, &count);
+
+    // Each message is processed as if it had come on its own, from the
+    // same source and with its own tag and size.
+    MPI_Status itemStatus = status;
+    while (position + headerSize <= count) {
+        memcpy(header, bufLarge + position, headerSize);
+        position += headerSize;
+        if (header[1] < 0 || position + header[1] > count) {
+            throw CoinError("Truncated envelope", "processEnvelope",
+                            "AlpsKnowledgeBrokerMPI");
+        }
+        char* item = bufLarge + position;
+        itemStatus.MPI_TAG = header[0];
+        MPI_Status_set_elements(&itemStatus, MPI_PACKED, header[1]);
+        const double start = profileClock();
+        processMessage(item, itemStatus);
+        profileRecv(header[0], header[1], start);
+        position += header[1];
     }
 }
 
 //#############################################################################
 
-// Process messages.
 void
-AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
-                                        MPI_Status &status,
-                                        MPI_Request &request)
+AlpsKnowledgeBrokerMPI::processMessage(char *&bufLarge, MPI_Status &status)
 {
     int count;
     bool success = false;
@@ -1843,13 +2041,12 @@ AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
         break;
     case AlpsMsgHubPeriodReport:
         masterUpdateSysStatus(bufLarge, &status, MPI_COMM_WORLD);
+        // A sub-master passes the news on to the master.
+        blockHubReport_ = false;
         break;
     case AlpsMsgTellMasterRecv:
         --masterDoBalance_;
         break;
-    case AlpsMsgWorkerAskIndices:
-        masterSendIndices(bufLarge);
-        break;
 
         //-------------------------------------------------
         // Following are hub's msgs.
@@ -1890,14 +2087,27 @@ AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
         donateWork(bufLarge, AlpsMsgSubTreeByWorker, &status);
         incSendCount("worker listening - AlpsMsgAskDonateToWorker");
         break;
+    case AlpsMsgStealRequest:
+        // Steal requests and empty replies are not counted, so that idle
+        // workers asking around do not hold up termination.
+        decRecvCount("worker listening - AlpsMsgStealRequest");
+        if (workingSubTree_ || subTreePool_->getNumKnowledges() > 1) {
+            if (donateWork(bufLarge, AlpsMsgSubTreeByWorker, &status)) {
+                incSendCount("worker listening - AlpsMsgStealRequest");
+            }
+        }
+        else {
+            // Giving away the only subtree would just move the idleness,
+            // and two idle workers could pass it back and forth forever.
+            ++(psStats_.donateFail_);
+            postSend(status.MPI_SOURCE, AlpsMsgSubTreeByWorker, bufLarge, 0);
+        }
+        break;
     case AlpsMsgAskPause:
         // Do not count messages during terminate checking
         decRecvCount("worker listening - AlpsMsgAskPause");
         blockTermCheck_ = false;
         break;
-    case AlpsMsgIndicesFromMaster:
-        workerRecvIndices(bufLarge);
-        break;
     case AlpsMsgSubTree:
         receiveSubTree(bufLarge, status.MPI_SOURCE, &status);
         tellHubRecv();
@@ -1905,6 +2115,7 @@ AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
         if (count > 0){
             blockWorkerReport_ = false;
             blockAskForWork_  = false;
+            ++tuneWorkRecv_;
         }
         break;
     case AlpsMsgSubTreeByWorker:
@@ -1913,7 +2124,22 @@ AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
         if (count > 0){
             blockWorkerReport_ = false;
             blockAskForWork_  = false;
+            ++tuneWorkRecv_;
+            stealDelay_ = 0.0;
+            stealNextTime_ = 0.0;
+        }
+        else {
+            ++tuneWorkEmpty_;
+            if (stealPending_) {
+                decRecvCount("worker listening - empty steal reply");
+                // Back off, so that idle workers do not flood the others
+                // with requests when there is little work left.
+                stealDelay_ = (stealDelay_ > 0.0) ?
+                    CoinMin(2.0 * stealDelay_, stealMaxDelay) : stealMinDelay;
+                stealNextTime_ = AlpsGetTimeOfDay() + stealDelay_;
+            }
         }
+        stealPending_ = false;
         break;
 
         //--------------------------------------------------
@@ -1921,8 +2147,8 @@ AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
         //--------------------------------------------------
 
     case AlpsMsgModelGenSearch:
-        receiveModelKnowledge(MPI_COMM_WORLD);
-        forwardModelKnowledge();
+        receiveModelKnowledge(MPI_COMM_WORLD, bufLarge);
+        forwardModelKnowledge(bufLarge);
         break;
     case AlpsMsgIncumbentTwo:
         success = unpackSetIncumbent(bufLarge, &status);
@@ -1935,11 +2161,11 @@ AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
         if (globalRank_ == masterRank_) {
             hubAllocateDonation(bufLarge, &status);
             MPI_Get_count(&status, MPI_PACKED, &count);
-            --masterDoBalance_;
+            tellMasterRecv(donationBalancer(status.MPI_SOURCE));
         }
         else if (globalRank_ == myHubRank_) {
             hubAllocateDonation(bufLarge, &status);
-            tellMasterRecv();
+            tellMasterRecv(donationBalancer(status.MPI_SOURCE));
             MPI_Get_count(&status, MPI_PACKED, &count);
             if (count > 0) {
                 blockHubReport_ = false;
@@ -1963,10 +2189,88 @@ AlpsKnowledgeBrokerMPI::processMessages(char *&bufLarge,
         throw CoinError("Unknown message type", "workermain",
                         "AlpsKnowledgeBrokerMPI");
     }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::queueMessage(int receiver,
+                                     int tag,
+                                     const char* buf,
+                                     int size)
+{
+    if (phase_ != AlpsPhaseSearch ||
+        !model_->AlpsPar()->entry(AlpsParams::coalesceMessages)) {
+        postSend(receiver, tag, buf, size);
+        return;
+    }
+
+    int header[2];
+    header[0] = tag;
+    header[1] = size;
+
+    std::vector<char>& envelope = envelopes_[receiver];
+    if (!envelope.empty() &&
+        envelope.size() + sizeof(header) + size >
+        static_cast<size_t>(largeSize_)) {
+        // Receivers post largeSize_ buffers.
+        flushMessages();
+    }
+    if (envelope.empty()) {
+        // Room for the incumbent, written when the envelope is sent.
+        envelope.resize(piggybackSize);
+    }
 
-    MPI_Irecv(bufLarge, largeSize_, MPI_PACKED, MPI_ANY_SOURCE,
-              MPI_ANY_TAG, MPI_COMM_WORLD, &request);
+    const char* start = reinterpret_cast<const char*>(header);
+    envelope.insert(envelope.end(), start, start + sizeof(header));
+    envelope.insert(envelope.end(), buf, buf + size);
+    profileSend(tag, size);
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::flushMessages()
+{
+    const int headerSize = static_cast<int>(2 * sizeof(int));
 
+    std::map<int, std::vector<char> >::iterator pos;
+    for (pos = envelopes_.begin(); pos != envelopes_.end(); ++pos) {
+        std::vector<char>& envelope = pos->second;
+        if (envelope.empty()) {
+            continue;
+        }
+        int header[2];
+        memcpy(header, &envelope[piggybackSize], headerSize);
+
+        // Hand the envelope to a send slot and take the slot's old buffer
+        // for the next round.
+        int slot = acquireSendSlot();
+        AlpsPendingSend* send = sendSlots_[slot];
+        send->buffer.swap(envelope);
+        envelope.clear();
+        packPiggyback(&send->buffer[0]);
+
+        send->postTime = profileClock();
+        if (piggybackSize + headerSize + header[1] ==
+            static_cast<int>(send->buffer.size())) {
+            // A single message goes out as itself.
+            send->tag = header[0];
+            transport_->send(pos->first, header[0],
+                             &send->buffer[0], piggybackSize,
+                             &send->buffer[0] + piggybackSize + headerSize,
+                             header[1], slot);
+        }
+        else {
+            send->tag = AlpsMsgEnvelope;
+            profileSend(AlpsMsgEnvelope,
+                        static_cast<int>(send->buffer.size()) -
+                        piggybackSize);
+            transport_->send(pos->first, AlpsMsgEnvelope, &send->buffer[0],
+                             static_cast<int>(send->buffer.size()),
+                             NULL, 0, slot);
+        }
+    }
 }
 
 //#############################################################################
@@ -1989,7 +2293,7 @@ AlpsKnowledgeBrokerMPI::masterAskHubDonate(int donorID,
     std::cout << "masterAskHubDonate(): donor is " << donorID << std::endl;
 #endif
 
-    MPI_Send(smallBuffer_,pos, MPI_PACKED, donorID, AlpsMsgAskHubShare, MPI_COMM_WORLD);
+    postSend(donorID, AlpsMsgAskHubShare, smallBuffer_, pos);
     incSendCount("masterAskHubDonate()");
 
 }
@@ -2014,8 +2318,7 @@ AlpsKnowledgeBrokerMPI::hubAskWorkerDonate(int donorID,
     std::cout << "hubAskHubDonate() send to " << donorID << std::endl;
 #endif
 
-    MPI_Send(smallBuffer_, pos, MPI_PACKED, donorID, AlpsMsgAskDonate,
-             MPI_COMM_WORLD);
+    postSend(donorID, AlpsMsgAskDonate, smallBuffer_, pos);
     incSendCount("hubAskWorkerDonate()");
 }
 
@@ -2084,7 +2387,7 @@ AlpsKnowledgeBrokerMPI::updateWorkloadInfo()
 //#############################################################################
 
 // A worker donates a subtree to another worker(whose info is in bufLarge)
-void
+bool
 AlpsKnowledgeBrokerMPI::donateWork(char*& anyBuffer,
                                    int tag,
                                    MPI_Status* status,
@@ -2124,51 +2427,23 @@ AlpsKnowledgeBrokerMPI::donateWork(char*& anyBuffer,
     }
 
 
-    //------------------------------------------------------
-    // Check if previous sending subtree has completed.
-    //------------------------------------------------------
-
-    int alreadySent = true;
-    if (subTreeRequest_ != MPI_REQUEST_NULL){
-        MPI_Status sentStatus;
-        MPI_Test(&subTreeRequest_, &alreadySent, &sentStatus);
-#if 0
-        if (alreadySent) {
-            std::cout << "++++ Process[" << globalRank_
-                      << "] have completed sending a subtree." << std::endl;
-        }
-        else {
-            std::cout << "++++ Process[" << globalRank_
-                      << "] haven't completed sending a subtree." << std::endl;
-        }
-#endif
-    }
-    else {
-#if 0
-        std::cout << "++++ Process[" << globalRank_
-                  << "] ready to sent a subtree." << std::endl;
-#endif
-    }
-
     //------------------------------------------------------
     // Case 1: If subTreePool has subtrees, send the best one.
     //         if the size of the best one is big large, split it.
     // Case 2: If subTreePool has no subtrees AND workingSubTree_ does not
     //         point to NULL, split it and send one part of it.
     // Case 3: Otherwise, sent a empty msg.
+    // With frontierDonation, only the open nodes of the subtrees are sent.
     //------------------------------------------------------
 
-    if (alreadySent) {
+    if (model_->AlpsPar()->entry(AlpsParams::frontierDonation)) {
         if (subTreePool_->hasKnowledge()) {   // Case 1
             aSubTree = dynamic_cast<AlpsSubTree* >
                 (subTreePool_->getKnowledge().first);
-            sentSuccessful = sendSubTree(receiverID, aSubTree, tag);
-
+            sentSuccessful = sendFrontier(receiverID, aSubTree, true, tag);
             if (sentSuccessful) {
                 ++(psStats_.subtreeWhole_);
-
                 subTreePool_->popKnowledge();
-                // Since sent to other process, delete it.
                 delete aSubTree;
                 aSubTree = NULL;
                 if (msgLevel_ > 100) {
@@ -2177,18 +2452,12 @@ AlpsKnowledgeBrokerMPI::donateWork(char*& anyBuffer,
                         << status->MPI_TAG << CoinMessageEol;
                 }
             }
-            else {
-                // Split subtree.
-                aSubTree = aSubTree->splitSubTree(treeSize);
-                if (treeSize > ALPS_GEN_TOL) {
-                    ++(psStats_.subtreeSplit_);
-                    sentSuccessful = sendSubTree(receiverID, aSubTree, tag);
-                    assert(sentSuccessful == true);
-                    // Since sent to other process, delete it.
-                    delete aSubTree;
-                    aSubTree = NULL;
-                }
-
+        }
+        else if (workingSubTree_ != 0) {      // Case 2
+            sentSuccessful = sendFrontier(receiverID, workingSubTree_, false,
+                                          tag);
+            if (sentSuccessful) {
+                ++(psStats_.subtreeSplit_);
                 if (msgLevel_ > 100) {
                     messageHandler()->message(ALPS_DONATE_SPLIT, messages())
                         << globalRank_ << receiverID << status->MPI_TAG
@@ -2196,37 +2465,72 @@ AlpsKnowledgeBrokerMPI::donateWork(char*& anyBuffer,
                 }
             }
         }
-        else if (workingSubTree_ != 0) {     // Case 2
-            aSubTree = workingSubTree_->splitSubTree(treeSize);
+    }
+    else if (subTreePool_->hasKnowledge()) {   // Case 1
+        aSubTree = dynamic_cast<AlpsSubTree* >
+            (subTreePool_->getKnowledge().first);
+        sentSuccessful = sendSubTree(receiverID, aSubTree, tag);
+
+        if (sentSuccessful) {
+            ++(psStats_.subtreeWhole_);
+
+            subTreePool_->popKnowledge();
+            // Since sent to other process, delete it.
+            delete aSubTree;
+            aSubTree = NULL;
+            if (msgLevel_ > 100) {
+                messageHandler()->message(ALPS_DONATE_WHOLE, messages())
+                    << globalRank_ << receiverID
+                    << status->MPI_TAG << CoinMessageEol;
+            }
+        }
+        else {
+            // Split subtree.
+            aSubTree = aSubTree->splitSubTree(treeSize);
             if (treeSize > ALPS_GEN_TOL) {
                 ++(psStats_.subtreeSplit_);
-
                 sentSuccessful = sendSubTree(receiverID, aSubTree, tag);
                 assert(sentSuccessful == true);
-
                 // Since sent to other process, delete it.
                 delete aSubTree;
                 aSubTree = NULL;
+            }
 
-                if (msgLevel_ > 100) {
-                    messageHandler()->message(ALPS_DONATE_SPLIT, messages())
-                        << globalRank_ << receiverID << status->MPI_TAG
-                        << CoinMessageEol;
-                }
+            if (msgLevel_ > 100) {
+                messageHandler()->message(ALPS_DONATE_SPLIT, messages())
+                    << globalRank_ << receiverID << status->MPI_TAG
+                    << CoinMessageEol;
+            }
+        }
+    }
+    else if (workingSubTree_ != 0) {     // Case 2
+        aSubTree = workingSubTree_->splitSubTree(treeSize);
+        if (treeSize > ALPS_GEN_TOL) {
+            ++(psStats_.subtreeSplit_);
+
+            sentSuccessful = sendSubTree(receiverID, aSubTree, tag);
+            assert(sentSuccessful == true);
+
+            // Since sent to other process, delete it.
+            delete aSubTree;
+            aSubTree = NULL;
+
+            if (msgLevel_ > 100) {
+                messageHandler()->message(ALPS_DONATE_SPLIT, messages())
+                    << globalRank_ << receiverID << status->MPI_TAG
+                    << CoinMessageEol;
             }
         }
     }
 
-    if (!sentSuccessful || !alreadySent) {               // Case 3
+    if (!sentSuccessful) {               // Case 3
 #if 0
         std::cout << "donateWork(): " << globalRank_ << "has nothing send to "
-                  << receiverID <<"; alreadySent "<<alreadySent<< std::endl;
+                  << receiverID << std::endl;
 #endif
         ++(psStats_.donateFail_);
 
-        //MPI_Send(dummyBuf, 0, MPI_PACKED, receiverID, tag, MPI_COMM_WORLD);
-        MPI_Isend(dummyBuf, 0, MPI_PACKED, receiverID, tag,
-                  MPI_COMM_WORLD, &subTreeRequest_); // request is overrided.
+        postSend(receiverID, tag, dummyBuf, 0);
 
         if (msgLevel_ > 100) {
             messageHandler()->message(ALPS_DONATE_FAIL, messages())
@@ -2244,6 +2548,49 @@ AlpsKnowledgeBrokerMPI::donateWork(char*& anyBuffer,
         << globalRank_ << workQuantity_ << subTreePool_->getNumKnowledges()
         << CoinMessageEol;
 #endif
+
+    return sentSuccessful;
+}
+
+//#############################################################################
+
+// An idle worker asks a randomly chosen worker, or hub that processes
+// nodes, for work. The victim answers through donateWork(), with an empty
+// message if it has nothing to give.
+void
+AlpsKnowledgeBrokerMPI::stealWork()
+{
+    if (stealVictims_.empty()) {
+        stealRandom_.seed(globalRank_ + 1);
+        for (int i = 0; i < processNum_; ++i) {
+            // Clusters of different sizes may differ in whether their hub
+            // works; an idle hub just answers with an empty message. The
+            // master never works, and a request still in flight when the
+            // search ends would be taken for a solution message.
+            if (i != globalRank_ && i != masterRank_ &&
+                (processTypeList_[i] == AlpsProcessTypeWorker || hubWork_)) {
+                stealVictims_.push_back(i);
+            }
+        }
+        if (stealVictims_.empty()) {
+            return;
+        }
+    }
+
+    std::uniform_int_distribution<int> pick(0, static_cast<int>
+                                            (stealVictims_.size()) - 1);
+    const int victim = stealVictims_[pick(stealRandom_)];
+
+    int pos = 0;
+    const int size = model_->AlpsPar()->entry(AlpsParams::smallSize);
+    MPI_Pack(&globalRank_, 1, MPI_INT, smallBuffer_, size, &pos,
+             MPI_COMM_WORLD);
+    MPI_Pack(&workQuantity_, 1, MPI_DOUBLE, smallBuffer_, size, &pos,
+             MPI_COMM_WORLD);
+    postSend(victim, AlpsMsgStealRequest, smallBuffer_, pos);
+
+    stealPending_ = true;
+    ++(psStats_.workerAsk_);
 }
 
 //#############################################################################
@@ -2270,13 +2617,17 @@ AlpsKnowledgeBrokerMPI::hubAllocateDonation(char*& bufLarge,
     // Find the worker who has worst work quality.
     //------------------------------------------------------
 
+    // The master never processes nodes, even in a working cluster; a
+    // subtree kept there would stall decentralized termination.
+    const bool selfWork = hubWork_ && globalRank_ != masterRank_;
+
     for (i = 0; i < clusterSize_; ++i) {
-        if (!hubWork_) {
+        if (!selfWork) {
             if (i == clusterRank_) continue;
         }
         if (workerWorkQuantities_[i] > worst) {
             worst = workerWorkQualities_[i];
-            worstRank = globalRank_ + i;
+            worstRank = clusterRanks_[i];
         }
     }
 
@@ -2291,8 +2642,7 @@ AlpsKnowledgeBrokerMPI::hubAllocateDonation(char*& bufLarge,
                   << worstRank << std::endl;
 #endif
         if (worstRank != globalRank_) {
-            MPI_Send(bufLarge, count, MPI_PACKED, worstRank,
-                     AlpsMsgSubTreeByMaster, MPI_COMM_WORLD);
+            postSend(worstRank, AlpsMsgSubTreeByMaster, bufLarge, count);
             incSendCount("hubAllocateDonation");
         }
         else { // Hub self
@@ -2333,12 +2683,9 @@ AlpsKnowledgeBrokerMPI::hubBalanceWorkers()
     std::multimap<double, int, std::greater<double> > receivers;
     std::multimap<double, int> donors;
 
-    const double donorSh      =
-        model_->AlpsPar()->entry(AlpsParams::donorThreshold);
-    const double receiverSh   =
-        model_->AlpsPar()->entry(AlpsParams::receiverThreshold);
-    const double needWorkThreshold =
-        model_->AlpsPar()->entry(AlpsParams::needWorkThreshold);
+    const double donorSh      = donorThreshold_;
+    const double receiverSh   = receiverThreshold_;
+    const double needWorkThreshold = needWorkThreshold_;
     assert(needWorkThreshold > 0.0);
 
     ++(psStats_.intraBalance_);
@@ -2358,7 +2705,7 @@ AlpsKnowledgeBrokerMPI::hubBalanceWorkers()
 
         if (workerWorkQuantities_[i] <= needWorkThreshold) {
             receivers.insert(std::pair<double, int>(workerWorkQualities_[i],
-                                                    globalRank_ - masterRank_ + i));
+                                                    clusterRanks_[i]));
             quantityBalance = true;
         }
     }
@@ -2371,7 +2718,7 @@ AlpsKnowledgeBrokerMPI::hubBalanceWorkers()
 
             if (workerWorkQuantities_[i] > needWorkThreshold) {
                 donors.insert(std::pair<double, int>(workerWorkQualities_[i],
-                                                     globalRank_-masterRank_ + i));
+                                                     clusterRanks_[i]));
             }
         }
     }
@@ -2391,12 +2738,12 @@ AlpsKnowledgeBrokerMPI::hubBalanceWorkers()
             double diffRatio = fabs(diff / averQuality);
             if (diff < 0 && diffRatio > donorSh) {  // Donor candidates
                 donors.insert(std::pair<double, int>(workerWorkQualities_[i],
-                                                     globalRank_ -masterRank_ + i));
+                                                     clusterRanks_[i]));
             }
             else if (diff > 0 && diffRatio > receiverSh){// Receiver candidates
                 receivers.insert(std::pair<double, int>(
                                      workerWorkQualities_[i],
-                                     globalRank_ - masterRank_ + i));
+                                     clusterRanks_[i]));
             }
         }
     }
@@ -2468,7 +2815,7 @@ AlpsKnowledgeBrokerMPI::hubSatisfyWorkerRequest(char*& bufLarge, MPI_Status* sta
     //------------------------------------------------------
 
     int requestor = status->MPI_SOURCE;
-    requestorRank = requestor % userClusterSize_;
+    requestorRank = clusterRankList_[requestor];
 
     //------------------------------------------------------
     // Find the worker having best quality in this cluster.
@@ -2483,7 +2830,7 @@ AlpsKnowledgeBrokerMPI::hubSatisfyWorkerRequest(char*& bufLarge, MPI_Status* sta
         if (workerWorkQualities_[i] < bestQuality) {
             bestQuality = workerWorkQualities_[i];
             donorRank = i;
-            donorGlobalRank = globalRank_ - masterRank_ + i;
+            donorGlobalRank = clusterRanks_[i];
         }
     }
 
@@ -2499,10 +2846,8 @@ AlpsKnowledgeBrokerMPI::hubSatisfyWorkerRequest(char*& bufLarge, MPI_Status* sta
                  MPI_COMM_WORLD);
         MPI_Pack(&temp, 1, MPI_DOUBLE, smallBuffer_, size, &pos,
                  MPI_COMM_WORLD);
-        MPI_Send(smallBuffer_, pos, MPI_PACKED,
-                 donorGlobalRank,
-                 AlpsMsgAskDonateToWorker,
-                 MPI_COMM_WORLD);
+        postSend(donorGlobalRank, AlpsMsgAskDonateToWorker, smallBuffer_,
+                 pos);
 
 #ifdef NF_DEBUG_MORE
         std::cout << "HUB " << globalRank_ << "ask worker " <<donorGlobalRank
@@ -2513,10 +2858,7 @@ AlpsKnowledgeBrokerMPI::hubSatisfyWorkerRequest(char*& bufLarge, MPI_Status* sta
         // Failed to find a donor, send a empty buffer to requestor.
         ++(psStats_.donateFail_);
 
-        MPI_Send(smallBuffer_, 0, MPI_PACKED,
-                 requestor,
-                 AlpsMsgSubTreeByWorker,
-                 MPI_COMM_WORLD);
+        postSend(requestor, AlpsMsgSubTreeByWorker, smallBuffer_, 0);
         if (msgLevel_ > 100) {
             messageHandler()->message(ALPS_LOADBAL_HUB_FAIL, messages())
                 << globalRank_ << requestor << CoinMessageEol;
@@ -2538,7 +2880,7 @@ AlpsKnowledgeBrokerMPI::hubReportStatus(int tag, MPI_Comm comm)
     int receiver;
 
     if (comm == MPI_COMM_WORLD) {
-        receiver = masterRank_;
+        receiver = parentRank_;
     }
     else if (comm == hubComm_) {
         // NOTE: master's rank is always 0 in hubComm_.
@@ -2555,29 +2897,52 @@ AlpsKnowledgeBrokerMPI::hubReportStatus(int tag, MPI_Comm comm)
     std::cout << "HUB " << globalRank_
               << " : quantity = " << clusterWorkQuantity_ << ", ";
     for (int i = 0; i < clusterSize_; ++i) {
-        std::cout << "w[" << globalRank_+i << "]="
+        std::cout << "w[" << clusterRanks_[i] << "]="
                   << workerWorkQuantities_[i] << ", ";
     }
     std::cout << std::endl;
     std::cout << "HUB " << globalRank_
               << " : quality = " << clusterWorkQuality_ << ", ";
     for (int i = 0; i < clusterSize_; ++i) {
-        std::cout << "w[" << globalRank_+i << "]="
+        std::cout << "w[" << clusterRanks_[i] << "]="
                   << workerWorkQualities_[i] << ", ";
     }
     std::cout << std::endl;
 #endif
 
-    MPI_Pack(&clusterNodeProcessed_, 1, MPI_INT, smallBuffer_,size,&pos, comm);
-    MPI_Pack(&clusterWorkQuality_, 1, MPI_DOUBLE, smallBuffer_,size,&pos,comm);
-    MPI_Pack(&clusterWorkQuantity_, 1, MPI_DOUBLE,smallBuffer_,size,&pos,comm);
-    MPI_Pack(&clusterSendCount_, 1, MPI_INT, smallBuffer_, size, &pos, comm);
-    MPI_Pack(&clusterRecvCount_, 1, MPI_INT, smallBuffer_, size, &pos, comm);
+    const double packStart = profileClock();
+    if (subMaster_ && comm == MPI_COMM_WORLD) {
+        // A sub-master reports its group as if it were one cluster.
+        MPI_Pack(&systemNodeProcessed_, 1, MPI_INT, smallBuffer_, size, &pos,
+                 comm);
+        MPI_Pack(&systemWorkQuality_, 1, MPI_DOUBLE, smallBuffer_, size, &pos,
+                 comm);
+        MPI_Pack(&systemWorkQuantity_, 1, MPI_DOUBLE, smallBuffer_, size,
+                 &pos, comm);
+        MPI_Pack(&systemSendCount_, 1, MPI_INT, smallBuffer_, size, &pos,
+                 comm);
+        MPI_Pack(&systemRecvCount_, 1, MPI_INT, smallBuffer_, size, &pos,
+                 comm);
+        systemSendCount_ = systemRecvCount_ = 0;
+    }
+    else {
+        MPI_Pack(&clusterNodeProcessed_, 1, MPI_INT, smallBuffer_,size,&pos, comm);
+        MPI_Pack(&clusterWorkQuality_, 1, MPI_DOUBLE, smallBuffer_,size,&pos,comm);
+        MPI_Pack(&clusterWorkQuantity_, 1, MPI_DOUBLE,smallBuffer_,size,&pos,comm);
+        MPI_Pack(&clusterSendCount_, 1, MPI_INT, smallBuffer_, size, &pos, comm);
+        MPI_Pack(&clusterRecvCount_, 1, MPI_INT, smallBuffer_, size, &pos, comm);
+    }
     MPI_Pack(&nodeProcessingTime_, 1, MPI_DOUBLE, smallBuffer_, size, &pos,
              comm);
     MPI_Pack(&unitWorkNodes_, 1, MPI_INT, smallBuffer_, size, &pos, comm);
+    profilePack(tag, packStart);
 
-    MPI_Send(smallBuffer_, pos, MPI_PACKED, receiver, tag, comm);
+    if (comm == MPI_COMM_WORLD) {
+        queueMessage(receiver, tag, smallBuffer_, pos);
+    }
+    else {
+        MPI_Send(smallBuffer_, pos, MPI_PACKED, receiver, tag, comm);
+    }
 
     clusterSendCount_ = clusterRecvCount_ = 0;  // Only count new msg
 }
@@ -2597,7 +2962,7 @@ AlpsKnowledgeBrokerMPI::hubUpdateCluStatus(char*& bufLarge,
     int size = model_->AlpsPar()->entry(AlpsParams::smallSize);
 
     if (comm == MPI_COMM_WORLD)
-        sender = (status->MPI_SOURCE) % userClusterSize_;
+        sender = clusterRankList_[status->MPI_SOURCE];
     else if (comm == clusterComm_)
         sender = status->MPI_SOURCE;
     else {
@@ -2757,7 +3122,7 @@ AlpsKnowledgeBrokerMPI::hubsShareWork(char*& bufLarge,
             if ( (workerWorkQuantities_[i] > ALPS_QUALITY_TOL) &&
                  (workerWorkQualities_[i] < maxLoad) ) {
                 maxLoad = workerWorkQualities_[i];
-                maxLoadRank = globalRank_ - masterRank_ + i;
+                maxLoadRank = clusterRanks_[i];
             }
         }
     }
@@ -2782,8 +3147,7 @@ AlpsKnowledgeBrokerMPI::hubsShareWork(char*& bufLarge,
                      &pos, MPI_COMM_WORLD);
             MPI_Pack(&receiverWorkload, 1, MPI_DOUBLE, smallBuffer_, size,
                      &pos, MPI_COMM_WORLD);
-            MPI_Send(smallBuffer_, pos, MPI_PACKED, maxLoadRank,
-                     AlpsMsgAskDonateToHub, MPI_COMM_WORLD);
+            postSend(maxLoadRank, AlpsMsgAskDonateToHub, smallBuffer_, pos);
             incSendCount("hubsShareWork");
         }
         else {
@@ -2808,9 +3172,9 @@ AlpsKnowledgeBrokerMPI::hubsShareWork(char*& bufLarge,
                 << globalRank_ << receiverID << CoinMessageEol;
         }
 
-        // See a empty msg to master to reduce masterDoBalance_ by 1
-        MPI_Send(smallBuffer_, 0, MPI_PACKED, masterRank_,
-                 AlpsMsgHubFailFindDonor, MPI_COMM_WORLD);
+        // See a empty msg to the master (or sub-master) that asked to
+        // reduce masterDoBalance_ by 1
+        postSend(status->MPI_SOURCE, AlpsMsgHubFailFindDonor, smallBuffer_, 0);
         incSendCount("hubsShareWork");
     }
 }
@@ -2834,18 +3198,17 @@ AlpsKnowledgeBrokerMPI::masterBalanceHubs()
 
     int i;
     int size = model_->AlpsPar()->entry(AlpsParams::smallSize);
+    const int childNum = static_cast<int>(childRanks_.size());
 
     std::vector<std::pair<double, int> > loadIDVector;
 
-    loadIDVector.reserve(hubNum_);
+    loadIDVector.reserve(childNum);
 
     std::multimap<double, int, std::greater<double> > receivers;
     std::multimap<double, int> donors;
 
-    const double donorSh      =
-        model_->AlpsPar()->entry(AlpsParams::donorThreshold);
-    const double receiverSh   =
-        model_->AlpsPar()->entry(AlpsParams::receiverThreshold);
+    const double donorSh      = donorThreshold_;
+    const double receiverSh   = receiverThreshold_;
 
     //------------------------------------------------------
     // Identify donors and receivers and decide do quality or quantity.
@@ -2855,15 +3218,15 @@ AlpsKnowledgeBrokerMPI::masterBalanceHubs()
     ++(psStats_.interBalance_);
 
     bool quantityBalance = false;
-    for (i = 0; i < hubNum_; ++i) {
+    for (i = 0; i < childNum; ++i) {
         if (hubWorkQuantities_[i] < ALPS_QUALITY_TOL) {    // Have not work
 #if 0
-            std::cout << "++++ master balance: find donor hub " << hubRanks_[i]
+            std::cout << "++++ master balance: find donor hub " << childRanks_[i]
                       << "; quantity = " << hubWorkQuantities_[i]
                       << std::endl;
 #endif
             receivers.insert(std::pair<double, int>(hubWorkQualities_[i],
-                                                    hubRanks_[i]));
+                                                    childRanks_[i]));
             quantityBalance = true;
         }
     }
@@ -2871,15 +3234,15 @@ AlpsKnowledgeBrokerMPI::masterBalanceHubs()
     if (quantityBalance) {  // Quantity balance
         ++(psStats_.quantityBalance_);
 
-        for (i = 0; i < hubNum_; ++i) {
+        for (i = 0; i < childNum; ++i) {
             if (hubWorkQuantities_[i] > ALPS_QUALITY_TOL) {
 #if 0
                 std::cout << "++++ master balance: find donor hub "
-                          << hubRanks_[i] << "; quantity = "
+                          << childRanks_[i] << "; quantity = "
                           << hubWorkQuantities_[i] << std::endl;
 #endif
                 donors.insert(std::pair<double, int>(hubWorkQualities_[i],
-                                                     hubRanks_[i]));
+                                                     childRanks_[i]));
             }
         }
     }
@@ -2887,31 +3250,31 @@ AlpsKnowledgeBrokerMPI::masterBalanceHubs()
         ++(psStats_.qualityBalance_);
 
         double averQuality  = 0.0;
-        for (i = 0; i < hubNum_; ++i) {
+        for (i = 0; i < childNum; ++i) {
             averQuality += hubWorkQualities_[i];
         }
-        averQuality /= hubNum_;
+        averQuality /= childNum;
 
-        for (i = 0; i < hubNum_; ++i) {
+        for (i = 0; i < childNum; ++i) {
             double diff = hubWorkQualities_[i] - averQuality;
             double diffRatio = fabs(diff / (averQuality + 1.0));
             if (diff < 0 && diffRatio > donorSh) {  // Donor candidates
 #if 0
                 std::cout << "++++ master balance: find donor hub "
-                          << hubRanks_[i] << "; quality = "
+                          << childRanks_[i] << "; quality = "
                           << hubWorkQualities_[i] << std::endl;
 #endif
                 donors.insert(std::pair<double, int>(hubWorkQualities_[i],
-                                                     hubRanks_[i]));
+                                                     childRanks_[i]));
             }
             else if (diff > 0 && diffRatio > receiverSh){// Receiver candidates
 #if 0
                 std::cout << "++++ master balance: quality: find receiver hub "
-                          << hubRanks_[i] << "; quality = "
+                          << childRanks_[i] << "; quality = "
                           << hubWorkQualities_[i] << std::endl;
 #endif
                 receivers.insert(std::pair<double, int>(hubWorkQualities_[i],
-                                                        hubRanks_[i]));
+                                                        childRanks_[i]));
             }
         }
     }
@@ -2958,11 +3321,11 @@ AlpsKnowledgeBrokerMPI::masterBalanceHubs()
 
         }
 
-        if (donorID != masterRank_) {
+        if (donorID != globalRank_) {
             ++masterDoBalance_;
             masterAskHubDonate(donorID, receiverID, posR->first);
         }
-        else {  // donor is the master
+        else {  // donor is the master (or this sub-master)
             double maxLoad = ALPS_DBL_MAX;
             int maxLoadRank = -1;
             int pos = 0;
@@ -2973,7 +3336,7 @@ AlpsKnowledgeBrokerMPI::masterBalanceHubs()
                 if (k != clusterRank_) {
                     if (workerWorkQualities_[k] < maxLoad) {
                         maxLoad = workerWorkQualities_[k];
-                        maxLoadRank = globalRank_ - masterRank_ + k;
+                        maxLoadRank = clusterRanks_[k];
                     }
                 }
             }
@@ -2987,8 +3350,8 @@ AlpsKnowledgeBrokerMPI::masterBalanceHubs()
                          MPI_COMM_WORLD);
 
                 incSendCount("masterBalanceHubs()");
-                MPI_Send(smallBuffer_, pos, MPI_PACKED, maxLoadRank,
-                         AlpsMsgAskDonateToHub, MPI_COMM_WORLD);
+                postSend(maxLoadRank, AlpsMsgAskDonateToHub, smallBuffer_,
+                         pos);
                 ++masterDoBalance_;
 
 #ifdef NF_DEBUG_MORE
@@ -3017,8 +3380,7 @@ AlpsKnowledgeBrokerMPI::masterUpdateSysStatus(char*& bufLarge,
     int size = model_->AlpsPar()->entry(AlpsParams::smallSize);
 
     if (comm == MPI_COMM_WORLD) {
-        //Be careful with / or %
-        sender = (int)(status->MPI_SOURCE) / userClusterSize_;
+        sender = hubChildIndex(clusterIndexList_[status->MPI_SOURCE]);
     }
     else if (comm == hubComm_) {
         sender = (int)(status->MPI_SOURCE);
@@ -3037,6 +3399,7 @@ AlpsKnowledgeBrokerMPI::masterUpdateSysStatus(char*& bufLarge,
     double preQuantity = hubWorkQuantities_[sender];
     double curQuantity;
     double npTime;
+    int unitWorkNodes;
 
     MPI_Unpack(bufLarge, size, &position, &curNodeProcessed, 1, MPI_INT, comm);
     MPI_Unpack(bufLarge, size, &position, &curQuality, 1, MPI_DOUBLE, comm);
@@ -3044,7 +3407,7 @@ AlpsKnowledgeBrokerMPI::masterUpdateSysStatus(char*& bufLarge,
     MPI_Unpack(bufLarge, size, &position, &msgSendNum, 1, MPI_INT, comm);
     MPI_Unpack(bufLarge, size, &position, &msgRecvNum, 1, MPI_INT, comm);
     MPI_Unpack(bufLarge, size, &position, &npTime, 1, MPI_DOUBLE, comm);
-    MPI_Unpack(bufLarge, size, &position, &unitWorkNodes_, 1, MPI_INT, comm);
+    MPI_Unpack(bufLarge, size, &position, &unitWorkNodes, 1, MPI_INT, comm);
 
     // Update the hub's status
     hubNodeProcesseds_[sender] = curNodeProcessed;
@@ -3079,7 +3442,13 @@ AlpsKnowledgeBrokerMPI::masterUpdateSysStatus(char*& bufLarge,
         systemRecvCount_ -= minCount;
     }
 
-    if (npTime != ALPS_NODE_PROCESS_TIME && npTime > 1.0e-10) {
+    // A sub-master keeps its own timing for the work it does as a hub.
+    if (processType_ == AlpsProcessTypeMaster) {
+        unitWorkNodes_ = unitWorkNodes;
+    }
+
+    if (processType_ == AlpsProcessTypeMaster &&
+        npTime != ALPS_NODE_PROCESS_TIME && npTime > 1.0e-10) {
         if (nodeProcessingTime_ == ALPS_NODE_PROCESS_TIME) {
             nodeProcessingTime_ = npTime;
         }
@@ -3118,23 +3487,27 @@ AlpsKnowledgeBrokerMPI::masterUpdateSysStatus(char*& bufLarge,
 void
 AlpsKnowledgeBrokerMPI::refreshSysStatus()
 {
-    //------------------------------------------------------
-    // Add master's quantity (0 anyway) to hub 1.
-    //------------------------------------------------------
-
-    workerWorkQuantities_[masterRank_] = workQuantity_;
-    clusterWorkQuantity_ += workerWorkQuantities_[masterRank_];
+    // NOTE: A sub-master has added itself to its cluster already, see
+    // refreshClusterStatus().
+    if (processType_ == AlpsProcessTypeMaster) {
+        //--------------------------------------------------
+        // Add master's quantity (0 anyway) to hub 1.
+        //--------------------------------------------------
 
-    //------------------------------------------------------
-    // Add master's node processed num to hub 1.
-    //------------------------------------------------------
+        workerWorkQuantities_[masterRank_] = workQuantity_;
+        clusterWorkQuantity_ += workerWorkQuantities_[masterRank_];
 
-    int preMasterNodeP = workerNodeProcesseds_[masterRank_];
-    workerNodeProcesseds_[masterRank_] = nodeProcessedNum_;
-    clusterNodeProcessed_ += workerNodeProcesseds_[masterRank_];
-    clusterNodeProcessed_ -= preMasterNodeP;
+        //--------------------------------------------------
+        // Add master's node processed num to hub 1.
+        //--------------------------------------------------
+
+        int preMasterNodeP = workerNodeProcesseds_[masterRank_];
+        workerNodeProcesseds_[masterRank_] = nodeProcessedNum_;
+        clusterNodeProcessed_ += workerNodeProcesseds_[masterRank_];
+        clusterNodeProcessed_ -= preMasterNodeP;
 
-    // Note: Nothing need to do about master's quality.
+        // Note: Nothing need to do about master's quality.
+    }
 
     //------------------------------------------------------
     // Add hub1(master) cluster's quantity into system.
@@ -3162,6 +3535,17 @@ AlpsKnowledgeBrokerMPI::refreshSysStatus()
     if (systemWorkQuantity_ < ALPS_QUALITY_TOL) {
         systemWorkQuality_ = ALPS_OBJ_MAX;
     }
+    else if (subMaster_) {
+        // The master balances on the quality a sub-master reports, so
+        // take the best quality of the group as it is now.
+        systemWorkQuality_ = ALPS_OBJ_MAX;
+        for (int k = 0; k < static_cast<int>(childRanks_.size()); ++k) {
+            if (hubWorkQuantities_[k] > ALPS_QUALITY_TOL) {
+                systemWorkQuality_ = std::min(systemWorkQuality_,
+                                              hubWorkQualities_[k]);
+            }
+        }
+    }
     else {
         systemWorkQuality_ = std::min(systemWorkQuality_,hubWorkQualities_[0]);
     }
@@ -3201,6 +3585,35 @@ AlpsKnowledgeBrokerMPI::refreshSysStatus()
 
 //#############################################################################
 
+// Hubs in the group of the master or a sub-master come first, in order;
+// the master then has one entry for every other group.
+int
+AlpsKnowledgeBrokerMPI::hubChildIndex(int hubIndex) const
+{
+    const int group = hubIndex / hubGroupSize_;
+    const int myGroup = clusterIndexList_[globalRank_] / hubGroupSize_;
+    if (group == myGroup) {
+        return hubIndex - group * hubGroupSize_;
+    }
+    return hubGroupSize_ + group - 1;
+}
+
+//#############################################################################
+
+// Hubs of the same group are paired by the leader of the group, hubs of
+// different groups by the master.
+int
+AlpsKnowledgeBrokerMPI::donationBalancer(int donor) const
+{
+    const int donorGroup = clusterIndexList_[donor] / hubGroupSize_;
+    if (donorGroup == clusterIndexList_[globalRank_] / hubGroupSize_) {
+        return hubRanks_[donorGroup * hubGroupSize_];
+    }
+    return masterRank_;
+}
+
+//#############################################################################
+
 // Add the state of the hub to cluster state
 void
 AlpsKnowledgeBrokerMPI::refreshClusterStatus()
@@ -3296,6 +3709,11 @@ AlpsKnowledgeBrokerMPI::unpackSetIncumbent(char*& bufLarge, MPI_Status* status)
 
         //updateIncumbent_ = true;        // The incumbent value is updated.
     }
+    else if (incVal == incumbentValue_ && incID == incumbentID_) {
+        // Already taken from the incumbent piggybacked on an earlier
+        // message, and counted then, but not yet passed on down the tree.
+        accept = true;
+    }
     else if(incVal == incumbentValue_ ) {
         ++solNum_;
         if (incID < incumbentID_) {     // So that all process consistant
@@ -3351,6 +3769,7 @@ AlpsKnowledgeBrokerMPI::workerReportStatus(int tag,
                         "AlpsKnowledgeBrokerMPI");
     }
 
+    const double packStart = profileClock();
     MPI_Pack(&nodeProcessedNum_, 1, MPI_INT, smallBuffer_, size, &pos, comm);
     MPI_Pack(&workQuality_, 1, MPI_DOUBLE, smallBuffer_, size, &pos, comm);
     MPI_Pack(&workQuantity_, 1, MPI_DOUBLE, smallBuffer_, size, &pos, comm);
@@ -3359,8 +3778,14 @@ AlpsKnowledgeBrokerMPI::workerReportStatus(int tag,
     MPI_Pack(&nodeProcessingTime_, 1, MPI_DOUBLE, smallBuffer_, size, &pos,
              comm);
     MPI_Pack(&unitWorkNodes_, 1, MPI_INT, smallBuffer_, size, &pos, comm);
+    profilePack(tag, packStart);
 
-    MPI_Send(smallBuffer_, pos, MPI_PACKED, receiver, tag, comm);
+    if (comm == MPI_COMM_WORLD) {
+        queueMessage(receiver, tag, smallBuffer_, pos);
+    }
+    else {
+        MPI_Send(smallBuffer_, pos, MPI_PACKED, receiver, tag, comm);
+    }
 
 #if 0
     std::cout << "WORKER " << globalRank_
@@ -3379,102 +3804,99 @@ AlpsKnowledgeBrokerMPI::workerReportStatus(int tag,
 //#############################################################################
 
 void
-AlpsKnowledgeBrokerMPI::workerRecvIndices(char *&bufLarge)
+AlpsKnowledgeBrokerMPI::pipelineBroadcast(char* buf,
+                                          int size,
+                                          int chunkSize,
+                                          int root,
+                                          MPI_Comm comm)
 {
-    int position = 0;
-    int size = 100;
-    int nextIndex;
-    int maxIndex;
+    int rank, numProcs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &numProcs);
 
-    MPI_Unpack(bufLarge, size, &position, &nextIndex, 1, MPI_INT,
-               MPI_COMM_WORLD);
-    MPI_Unpack(bufLarge, size, &position, &maxIndex, 1, MPI_INT,
-               MPI_COMM_WORLD);
+    if (chunkSize <= 0 || chunkSize >= size) {
+        MPI_Bcast(buf, size, MPI_CHAR, root, comm);
+        return;
+    }
 
-#if 0
-    std::cout << "++++ worker[" << globalRank_
-              << "] received indices from master"
-              << ", nextIndex = " << nextIndex
-              << ", maxIndex = " << maxIndex
-              << std::endl;
-#endif
+    //------------------------------------------------------
+    // Position in a binary tree rooted at root.
+    //------------------------------------------------------
 
-    if (nextIndex < 0 || maxIndex < 0 || nextIndex > maxIndex) {
-        haltSearch_ = true;
+    const int seq = (rank - root + numProcs) % numProcs;
+    const int parent = (seq == 0) ? -1 : ((seq - 1) / 2 + root) % numProcs;
+    int children[2];
+    int numChildren = 0;
+    if (2 * seq + 1 < numProcs) {
+        children[numChildren++] = (2 * seq + 1 + root) % numProcs;
     }
-    else {
-        haltSearch_ = false;
-        setNextNodeIndex(nextIndex);
-        setMaxNodeIndex(maxIndex);
+    if (2 * seq + 2 < numProcs) {
+        children[numChildren++] = (2 * seq + 2 + root) % numProcs;
     }
-}
 
-//#############################################################################
+    const int numChunks = (size + chunkSize - 1) / chunkSize;
 
-void
-AlpsKnowledgeBrokerMPI::workerAskIndices()
-{
-    int position = 0;
-    int size = model_->AlpsPar()->entry(AlpsParams::smallSize);
+    //------------------------------------------------------
+    // Post receives of all chunks, then forward each chunk as soon as it
+    // arrives.
+    //------------------------------------------------------
 
-#if 0
-    std::cout << "++++ worker[" << globalRank_ << "] ask indices from master."
-              << std::endl;
-#endif
+    std::vector<MPI_Request> recvRequests(numChunks, MPI_REQUEST_NULL);
+    std::vector<MPI_Request> sendRequests;
+    sendRequests.reserve(numChunks * numChildren);
 
-    MPI_Pack(&globalRank_, 1, MPI_INT, smallBuffer_, size, &position,
-             MPI_COMM_WORLD);
-    MPI_Send(smallBuffer_, position, MPI_PACKED, masterRank_,
-             AlpsMsgWorkerAskIndices, MPI_COMM_WORLD);
-    incSendCount("workerAskIndices()");
+    int k, c;
+    if (parent >= 0) {
+        for (k = 0; k < numChunks; ++k) {
+            int len = CoinMin(chunkSize, size - k * chunkSize);
+            MPI_Irecv(buf + k * chunkSize, len, MPI_CHAR, parent,
+                      AlpsMsgModelChunk, comm, &recvRequests[k]);
+        }
+    }
+
+    for (k = 0; k < numChunks; ++k) {
+        int len = CoinMin(chunkSize, size - k * chunkSize);
+        MPI_Wait(&recvRequests[k], MPI_STATUS_IGNORE);
+        for (c = 0; c < numChildren; ++c) {
+            MPI_Request request;
+            MPI_Isend(buf + k * chunkSize, len, MPI_CHAR, children[c],
+                      AlpsMsgModelChunk, comm, &request);
+            sendRequests.push_back(request);
+        }
+    }
+
+    if (!sendRequests.empty()) {
+        MPI_Waitall(static_cast<int>(sendRequests.size()), &sendRequests[0],
+                    MPI_STATUSES_IGNORE);
+    }
 }
 
 //#############################################################################
 
-void
-AlpsKnowledgeBrokerMPI::masterSendIndices(char *&bufLarge)
+/** Store an encoded model in the model cache. The file is written under a
+    temporary name and renamed, so that readers never see a partial file.
+    Failures are ignored since the cache is only an optimization. */
+static void
+writeModelCache(const std::string& cacheFile, AlpsEncoded* encodedModel,
+                int rank)
 {
-    int nextIndex = getNextNodeIndex();
-    int maxIndex = getMaxNodeIndex();
-    int leftIndex = maxIndex - nextIndex;
-
-    int pos = 0;
-    int size = 100;
-    int recvWorker = -1;
+    char suffix[32];
+    sprintf(suffix, ".tmp%d", rank);
+    std::string tempFile = cacheFile + suffix;
 
-    if (leftIndex >  masterIndexBatch_) {
-        maxIndex = nextIndex + masterIndexBatch_;
-        setNextNodeIndex(maxIndex + 1);
-    }
-    else if (leftIndex > 100) {
-        setNextNodeIndex(maxIndex);
+    FILE* fp = fopen(tempFile.c_str(), "wb");
+    if (fp == NULL) {
+        return;
     }
-    else {
-        // No index
-        forceTerminate_ = true;
-        nextIndex = -1;
-        maxIndex = -1;
+    size_t written = fwrite(encodedModel->representation(), 1,
+                            encodedModel->size(), fp);
+    if (fclose(fp) == 0 &&
+        written == static_cast<size_t>(encodedModel->size())) {
+        if (rename(tempFile.c_str(), cacheFile.c_str()) == 0) {
+            return;
+        }
     }
-
-    // Unpack the rank of worker.
-    MPI_Unpack(bufLarge, size, &pos, &recvWorker, 1, MPI_INT, MPI_COMM_WORLD);
-
-#if 0
-    std::cout << "++++ master[" << globalRank_ << "] send indices to worker "
-              << recvWorker << ", nextIndex = " << nextIndex
-              << ", maxIndex = " << maxIndex
-              << std::endl;
-#endif
-
-    // Pack nextIndex and maxIndex into small buffer and send it.
-    pos = 0;
-    MPI_Pack(&nextIndex, 1, MPI_INT, smallBuffer_, size, &pos,
-             MPI_COMM_WORLD);
-    MPI_Pack(&maxIndex, 1, MPI_INT, smallBuffer_, size, &pos,
-             MPI_COMM_WORLD);
-    MPI_Send(smallBuffer_, pos, MPI_PACKED, recvWorker,
-             AlpsMsgIndicesFromMaster, MPI_COMM_WORLD);
-    incSendCount("masterSendIndices");
+    remove(tempFile.c_str());
 }
 
 //#############################################################################
@@ -3487,63 +3909,141 @@ AlpsKnowledgeBrokerMPI::broadcastModel(const int id, const int sender)
     int position = 0;  // Initialize to 0
     AlpsEncoded* encodedModel = NULL;
 
+    // Size and type of the encoded model, length of the cache file name,
+    // and the chunk size of the broadcast.
+    int header[4] = {0, 0, 0, 0};
+    std::string cacheFile;
+    bool cacheHit = false;
+
     //------------------------------------------------------
-    // Encode matrix and pack into modelBuffer.
+    // Encode model and name its cache file by content hash.
     //------------------------------------------------------
 
     if (id == sender) {
-        // Pack model
         encodedModel = model_->encode();
-        packEncoded(encodedModel, modelBuffer, size, position, MPI_COMM_WORLD);
+        header[0] = encodedModel->size();
+        header[1] = encodedModel->type();
+        header[3] = model_->AlpsPar()->entry(AlpsParams::modelChunkSize);
 
-#ifdef NF_DEBUG
-        std::cout << "MASTER: packed model. size = "
-                  << size << std::endl;
-#endif
+        std::string cacheDir =
+            model_->AlpsPar()->entry(AlpsParams::modelCacheDir);
+        if (cacheDir != "NONE") {
+            char hashStr[32];
+            sprintf(hashStr, "%016llx",
+                    AlpsHashBytes(encodedModel->representation(),
+                                  encodedModel->size()));
+            cacheFile = cacheDir + "/alps-model-" + hashStr + ".enc";
+            header[2] = static_cast<int>(cacheFile.length());
+        }
     }
 
     //------------------------------------------------------
-    // Broadcost the size of matrix.
+    // Broadcast the size of model and the cache file name, and look up
+    // the model in the cache.
     //------------------------------------------------------
 
-    // Broadcast modelBuffer size first
-    MPI_Bcast(&size, 1, MPI_INT, sender, MPI_COMM_WORLD);
+    MPI_Bcast(header, 4, MPI_INT, sender, MPI_COMM_WORLD);
 
-    if (id != sender) {
-        // Process except master receive the size of model.
-        if (size <= 0) {
-            throw CoinError("Msg size <= 0",
-                            "broadcastModel",
-                            "AlpsKnowledgeBrokerMPI");
-        }
-        if( modelBuffer != NULL ) {
-            delete [] modelBuffer;
-            modelBuffer = NULL;
+    if (header[2] > 0) {
+        std::vector<char> name(cacheFile.begin(), cacheFile.end());
+        name.resize(header[2]);
+        MPI_Bcast(&name[0], header[2], MPI_CHAR, sender, MPI_COMM_WORLD);
+        cacheFile.assign(name.begin(), name.end());
+
+        if (id != sender) {
+            AlpsMappedFile cached(cacheFile);
+            if (cached.length() == header[0]) {
+                char* rep = new char [header[0] + 1];
+                memcpy(rep, cached.data(), header[0]);
+                // AlpsEncoded takes over rep.
+                encodedModel = new AlpsEncoded(header[1], header[0], rep);
+                cacheHit = true;
+            }
         }
-        modelBuffer = new char[size + 100];
     }
 
     //------------------------------------------------------
-    // Broadcost matrix.
+    // Only processes that do not have the model take part in the
+    // broadcast. The sender is rank 0 of missComm.
     //------------------------------------------------------
 
-    MPI_Bcast(modelBuffer, size, MPI_CHAR, sender, MPI_COMM_WORLD);
+    MPI_Comm missComm = MPI_COMM_WORLD;
+    int root = sender;
 
-    if (id != sender) {
+    if (header[2] > 0) {
+        MPI_Comm_split(MPI_COMM_WORLD,
+                       cacheHit ? MPI_UNDEFINED : 0,
+                       (id == sender) ? -1 : id,
+                       &missComm);
+        root = 0;
+    }
+
+    if (missComm != MPI_COMM_NULL) {
+
+        //--------------------------------------------------
+        // Pack model into modelBuffer.
+        //--------------------------------------------------
+
+        if (id == sender) {
+            packEncoded(encodedModel, modelBuffer, size, position, missComm);
+
+#ifdef NF_DEBUG
+            std::cout << "MASTER: packed model. size = "
+                      << size << std::endl;
+#endif
+        }
+
+        //--------------------------------------------------
+        // Broadcost the size of matrix.
+        //--------------------------------------------------
+
+        // Broadcast modelBuffer size first
+        MPI_Bcast(&size, 1, MPI_INT, root, missComm);
+
+        if (id != sender) {
+            // Process except master receive the size of model.
+            if (size <= 0) {
+                throw CoinError("Msg size <= 0",
+                                "broadcastModel",
+                                "AlpsKnowledgeBrokerMPI");
+            }
+            modelBuffer = new char[size + 100];
+        }
 
         //--------------------------------------------------
-        // Unpack to encoded model.
+        // Broadcost matrix in pipelined chunks.
         //--------------------------------------------------
 
-        position = 0;
-        encodedModel = unpackEncoded(modelBuffer,
-                                     position,
-                                     MPI_COMM_WORLD,
-                                     size+100);
+        pipelineBroadcast(modelBuffer, size, header[3], root, missComm);
+
+        if (id != sender) {
+
+            //----------------------------------------------
+            // Unpack to encoded model.
+            //----------------------------------------------
+
+            position = 0;
+            encodedModel = unpackEncoded(modelBuffer,
+                                         position,
+                                         missComm,
+                                         size+100);
+
+            if (header[2] > 0) {
+                writeModelCache(cacheFile, encodedModel, id);
+            }
+        }
+
+        if (missComm != MPI_COMM_WORLD) {
+            MPI_Comm_free(&missComm);
+        }
+    }
+
+    if (id != sender) {
 
 #ifdef NF_DEBUG
         std::cout << "PROCESS[" <<id<< "]: start to decode model."
-                  << ", knowledge type="<< encodedModel->type() << std::endl;
+                  << ", knowledge type="<< encodedModel->type()
+                  << ", from cache=" << cacheHit << std::endl;
 #endif
 
         //--------------------------------------------------
@@ -3559,12 +4059,11 @@ AlpsKnowledgeBrokerMPI::broadcastModel(const int id, const int sender)
 #endif
 
         //--------------------------------------------------
-        // Set up self.
+        // Set up self once the process type is known, see
+        // initializeSearch().
         //--------------------------------------------------
 
-        //(modifyDataPool()->getModel())->setupSelf();
-
-        model_->setupSelf();
+        deferSetupSelf_ = true;
     }
 
     if (modelBuffer) {
@@ -3607,8 +4106,8 @@ AlpsKnowledgeBrokerMPI::sendIncumbent()
                   <<" : init send a solution - L,  value = "
                   << incumbentValue_ << " to "<< leftRank << std::endl;
 #endif
-        MPI_Isend(smallBuffer_, position, MPI_PACKED, leftRank,
-                  AlpsMsgIncumbentTwo, MPI_COMM_WORLD, &forwardRequestL_);
+        queueMessage(leftRank, AlpsMsgIncumbentTwo, smallBuffer_, position);
+        incSendCount("sendIncumbent()");
     }
 
     if (rightSeq != -1) {
@@ -3618,20 +4117,132 @@ AlpsKnowledgeBrokerMPI::sendIncumbent()
                   <<" : init send a solution - R,  value = "
                   << incumbentValue_ << " to "<< rightRank << std::endl;
 #endif
-        MPI_Isend(smallBuffer_, position, MPI_PACKED, rightRank,
-                  AlpsMsgIncumbentTwo, MPI_COMM_WORLD, &forwardRequestR_);
+        queueMessage(rightRank, AlpsMsgIncumbentTwo, smallBuffer_, position);
+        incSendCount("sendIncumbent()");
     }
+}
 
-    if (leftSeq != -1) {
-        MPI_Status sentStatusL;
-        MPI_Wait(&forwardRequestL_, &sentStatusL);
-        incSendCount("sendIncumbent()");
+//#############################################################################
+
+// Layout of MPI_DOUBLE_INT.
+struct AlpsIncumbentPair {
+    double value;
+    int rank;
+};
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::createIncumbentWindow()
+{
+    if (!model_->AlpsPar()->entry(AlpsParams::incumbentWindow)) {
+        return;
     }
 
-    if (rightSeq != -1) {
-        MPI_Status sentStatusR;
-        MPI_Wait(&forwardRequestR_, &sentStatusR);
-        incSendCount("sendIncumbent()");
+    // Only the master exposes memory.
+    MPI_Aint winSize = 0;
+    if (globalRank_ == masterRank_) {
+        winSize = sizeof(AlpsIncumbentPair);
+    }
+    AlpsIncumbentPair* base = NULL;
+    MPI_Win_allocate(winSize, sizeof(AlpsIncumbentPair), MPI_INFO_NULL,
+                     MPI_COMM_WORLD, &base, &incumbentWin_);
+
+    if (globalRank_ == masterRank_) {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, masterRank_, 0, incumbentWin_);
+        base->value = incumbentValue_;
+        base->rank = processNum_;    // Loses every MINLOC tie.
+        MPI_Win_unlock(masterRank_, incumbentWin_);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::freeIncumbentWindow()
+{
+    if (incumbentWin_ != MPI_WIN_NULL) {
+        MPI_Win_free(&incumbentWin_);
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::publishIncumbent()
+{
+    AlpsIncumbentPair mine;
+    mine.value = incumbentValue_;
+    mine.rank = incumbentID_;
+
+    // MINLOC keeps the smaller rank on ties, as unpackSetIncumbent does.
+    MPI_Win_lock(MPI_LOCK_SHARED, masterRank_, 0, incumbentWin_);
+    MPI_Accumulate(&mine, 1, MPI_DOUBLE_INT, masterRank_, 0, 1,
+                   MPI_DOUBLE_INT, MPI_MINLOC, incumbentWin_);
+    MPI_Win_unlock(masterRank_, incumbentWin_);
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::readIncumbent()
+{
+    if (incumbentWin_ == MPI_WIN_NULL) {
+        return;
+    }
+
+    AlpsIncumbentPair global;
+    MPI_Win_lock(MPI_LOCK_SHARED, masterRank_, 0, incumbentWin_);
+    MPI_Get_accumulate(NULL, 0, MPI_DOUBLE_INT, &global, 1, MPI_DOUBLE_INT,
+                       masterRank_, 0, 1, MPI_DOUBLE_INT, MPI_NO_OP,
+                       incumbentWin_);
+    MPI_Win_unlock(masterRank_, incumbentWin_);
+
+    if (global.value < incumbentValue_) {
+        ++solNum_;
+        incumbentValue_ = global.value;
+        incumbentID_ = global.rank;
+        if (globalRank_ == masterRank_) {
+            bestSolNode_ = systemNodeProcessed_;
+        }
+    }
+    else if (global.value == incumbentValue_ &&
+             global.rank < incumbentID_) {
+        incumbentID_ = global.rank;
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::packPiggyback(char* buf) const
+{
+    memcpy(buf, &incumbentValue_, sizeof(double));
+    memcpy(buf + sizeof(double), &incumbentID_, sizeof(int));
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::unpackPiggyback(const char* buf)
+{
+    double incVal = ALPS_OBJ_MAX;
+    int incID = 0;
+    memcpy(&incVal, buf, sizeof(double));
+    memcpy(&incID, buf + sizeof(double), sizeof(int));
+
+    // Same rule as unpackSetIncumbent: the smaller rank wins ties.
+    if (incVal < incumbentValue_) {
+        ++solNum_;
+        incumbentValue_ = incVal;
+        incumbentID_ = incID;
+        if (globalRank_ == masterRank_) {
+            bestSolNode_ = systemNodeProcessed_;
+        }
+    }
+    else if (incVal == incumbentValue_ && incID < incumbentID_) {
+        incumbentID_ = incID;
     }
 }
 
@@ -3642,7 +4253,6 @@ AlpsKnowledgeBrokerMPI::collectBestSolution(int destination)
 {
     MPI_Status status;
     int sender = incumbentID_;
-    int position = 0;
 
 #ifdef NF_DEBUG
     std::cout << "CollectBestSolution: sender=" << sender
@@ -3654,25 +4264,16 @@ AlpsKnowledgeBrokerMPI::collectBestSolution(int destination)
     }
     else {
         if (globalRank_ == sender) {                 // Send solu
-            char* senderBuf = NULL;  // MUST init to NULL, otherwise
-            int size = -1;           // packEncoded(..) crashes.
-
             const AlpsSolution* solu = static_cast<const AlpsSolution* >
                 (getBestKnowledge(AlpsKnowledgeTypeSolution).first);
 
             double value = getBestKnowledge(AlpsKnowledgeTypeSolution).second;
 
             AlpsEncoded* enc = solu->encode();
-            packEncoded(enc, senderBuf, size, position, MPI_COMM_WORLD);
-
-            sendSizeBuf(senderBuf, size, position, destination,
-                        AlpsMsgIncumbent, MPI_COMM_WORLD);
+            sendSizeEncoded(enc, destination, AlpsMsgIncumbent,
+                            MPI_COMM_WORLD);
             MPI_Send(&value, 1, MPI_DOUBLE, destination, AlpsMsgIncumbent,
                      MPI_COMM_WORLD);
-            if(senderBuf) {
-                delete [] senderBuf;
-                senderBuf = NULL;
-            }
 
             delete enc;
             enc = NULL;
@@ -3684,26 +4285,19 @@ AlpsKnowledgeBrokerMPI::collectBestSolution(int destination)
         }
         else if (globalRank_ == destination) {            // Recv solu
             double value = 0.0;
-            char* destBuf = NULL;  //new char [ls];
 
-            receiveSizeBuf(destBuf, sender, AlpsMsgIncumbent,
-                           MPI_COMM_WORLD, &status);
+            AlpsEncoded* encodedSolu = receiveSizeEncoded(sender,
+                                                          AlpsMsgIncumbent,
+                                                          MPI_COMM_WORLD,
+                                                          &status);
             MPI_Recv(&value, 1, MPI_DOUBLE, sender, AlpsMsgIncumbent,
                      MPI_COMM_WORLD, &status);
 
-            position = 0;
-            AlpsEncoded* encodedSolu = unpackEncoded(destBuf,
-                                                     position,
-                                                     MPI_COMM_WORLD);
             AlpsSolution* bestSolu = static_cast<AlpsSolution* >
                 ( decoderObject(encodedSolu->type())->decode(*encodedSolu) );
 
             addKnowledge(AlpsKnowledgeTypeSolution, bestSolu, value);
 
-            if(destBuf) {
-                delete [] destBuf;
-                destBuf = NULL;
-            }
             if (encodedSolu) {
                 delete encodedSolu;
                 encodedSolu = NULL;
@@ -3719,12 +4313,15 @@ AlpsKnowledgeBrokerMPI::collectBestSolution(int destination)
 //#############################################################################
 
 void
-AlpsKnowledgeBrokerMPI::tellMasterRecv()
+AlpsKnowledgeBrokerMPI::tellMasterRecv(int balancer)
 {
     char* dummyBuf = 0;
-    MPI_Send(dummyBuf, 0, MPI_CHAR, masterRank_, AlpsMsgTellMasterRecv,
-             MPI_COMM_WORLD);
-    incSendCount("tellMasterRecv()");
+    if (balancer == globalRank_)
+        --masterDoBalance_;
+    else {
+        postSend(balancer, AlpsMsgTellMasterRecv, dummyBuf, 0);
+        incSendCount("tellMasterRecv()");
+    }
 }
 
 //#############################################################################
@@ -3736,14 +4333,40 @@ AlpsKnowledgeBrokerMPI::tellHubRecv()
     if (globalRank_ == myHubRank_)
         --hubDoBalance_;
     else {
-        MPI_Send(dummyBuf, 0, MPI_CHAR, myHubRank_, AlpsMsgTellHubRecv,
-                 MPI_COMM_WORLD);
+        postSend(myHubRank_, AlpsMsgTellHubRecv, dummyBuf, 0);
         incSendCount("tellHubRecv()");
     }
 }
 
 //#############################################################################
 
+// Build a datatype covering a {type, size} header followed by a
+// representation of repSize bytes, addressed from MPI_BOTTOM. Used to send
+// or receive an encoded object without packing it into a buffer first.
+static MPI_Datatype encodedDatatype(int* header, char* rep, int repSize)
+{
+    int blockLengths[2] = { static_cast<int>(2 * sizeof(int)), repSize };
+    MPI_Aint displacements[2];
+    MPI_Datatype type;
+
+    MPI_Get_address(header, &displacements[0]);
+    MPI_Get_address(rep, &displacements[1]);
+    MPI_Type_create_hindexed(2, blockLengths, displacements, MPI_BYTE, &type);
+    MPI_Type_commit(&type);
+
+    return type;
+}
+
+//#############################################################################
+
+// A segment of the shared subtree window starts with a busy flag, followed
+// by an encoded subtree as written by packEncoded(). The message that
+// announces it carries sharedSubTreeMarker in place of the type.
+static const int sharedSubTreeOffset = 8;
+static const int sharedSubTreeMarker = -1;
+
+//#############################################################################
+
 void
 AlpsKnowledgeBrokerMPI::packEncoded(AlpsEncoded* enc,
                                     char*& packBuffer,
@@ -3753,21 +4376,27 @@ AlpsKnowledgeBrokerMPI::packEncoded(AlpsEncoded* enc,
 {
     const int bufSpare = model_->AlpsPar()->entry(AlpsParams::bufSpare);
 
-    int type = static_cast<int>(enc->type());
-    int repSize = static_cast<int>(enc->size());
+    int header[2];
+    header[0] = static_cast<int>(enc->type());
+    header[1] = static_cast<int>(enc->size());
 
     if(!packBuffer) {
-        size = static_cast<int>(repSize + 2*sizeof(int) + bufSpare);
+        size = static_cast<int>(header[1] + sizeof(header) + bufSpare);
         packBuffer = new char[size];
     }
 
-    // Pack repSize, type_, representation_ of enc
-    MPI_Pack(&type, 1, MPI_INT, packBuffer, size, &position, comm);
-    MPI_Pack(&repSize, 1, MPI_INT, packBuffer, size, &position, comm);
-    //MPI_Pack(const_cast<char*>(type), typeSize, MPI_CHAR,
-    //packBuffer, size, &position, comm);
-    MPI_Pack(const_cast<char*>(enc->representation()), repSize, MPI_CHAR,
-             packBuffer, size, &position, comm);
+    if (position + static_cast<int>(sizeof(header)) + header[1] > size) {
+        throw CoinError("Buffer is too small", "packEncoded",
+                        "AlpsKnowledgeBrokerMPI");
+    }
+
+    // Copy type, repSize and representation_ of enc as raw bytes. This is
+    // layout compatible with MPI_Pack of native ints on homogeneous systems,
+    // so it can be mixed with MPI_Pack'ed fields in the same buffer.
+    memcpy(packBuffer + position, header, sizeof(header));
+    position += static_cast<int>(sizeof(header));
+    memcpy(packBuffer + position, enc->representation(), header[1]);
+    position += header[1];
 }
 
 //#############################################################################
@@ -3778,25 +4407,31 @@ AlpsKnowledgeBrokerMPI::unpackEncoded(char*& unpackBuffer,
                                       MPI_Comm comm,
                                       int size)
 {
-    int type, repSize;
+    int header[2];
     AlpsEncoded *encoded = NULL;
 
     if (size <= 0) {
         size = largeSize_;
     }
 
-    // Unpack typeSize, repSize, type and rep from unpackBuffer_
-    MPI_Unpack(unpackBuffer, size, &position, &type, 1, MPI_INT, comm);
+    if (position + static_cast<int>(sizeof(header)) > size) {
+        throw CoinError("Truncated message", "unpackEncoded",
+                        "AlpsKnowledgeBrokerMPI");
+    }
+    memcpy(header, unpackBuffer + position, sizeof(header));
+    position += static_cast<int>(sizeof(header));
 
-#if defined(NF_DEBUG_MORE)
-    std::cout << "PROC "<< globalRank_ <<" : typeSize is "
-              << typeSize << ";\tsize = "<< size <<  std::endl;
-#endif
+    int type = header[0];
+    int repSize = header[1];
 
-    MPI_Unpack(unpackBuffer, size, &position, &repSize, 1, MPI_INT, comm);
+    if (repSize < 0 || position + repSize > size) {
+        throw CoinError("Truncated message", "unpackEncoded",
+                        "AlpsKnowledgeBrokerMPI");
+    }
 
     char *rep = new char[repSize + 1];
-    MPI_Unpack(unpackBuffer, size, &position, rep, repSize, MPI_CHAR, comm);
+    memcpy(rep, unpackBuffer + position, repSize);
+    position += repSize;
     rep[repSize] = '\0';
 
 #if defined(NF_DEBUG_MORE)
@@ -3812,33 +4447,42 @@ AlpsKnowledgeBrokerMPI::unpackEncoded(char*& unpackBuffer,
 
 //#############################################################################
 
-void
-AlpsKnowledgeBrokerMPI::receiveSizeBuf(char*& buf,
-                                       int sender,
-                                       int tag,
-                                       MPI_Comm comm,
-                                       MPI_Status* status)
+AlpsEncoded*
+AlpsKnowledgeBrokerMPI::receiveSizeEncoded(int sender,
+                                           int tag,
+                                           MPI_Comm comm,
+                                           MPI_Status* status)
 {
     int size = -1;
+    int header[2];
 
     // First recv the msg size
     MPI_Recv(&size, 1, MPI_INT, sender, MPI_ANY_TAG, comm, status);
     if (status->MPI_TAG == AlpsMsgFinishInit)
-        return;
+        return NULL;
 
-    if (size < 0) {
-        throw CoinError("size < 0", "receiveSizeBuf",
+    if (size < static_cast<int>(sizeof(header))) {
+        throw CoinError("size < 0", "receiveSizeEncoded",
                         "AlpsKnowledgeBrokerMPI");
     }
 
-    // Second, allocate memory for buf
-    if (buf != 0) {
-        delete [] buf;  buf = 0;
+    // Second, allocate the representation and receive the header and the
+    // representation directly into their final places.
+    int repSize = size - static_cast<int>(sizeof(header));
+    char* rep = new char [repSize + 1];
+    MPI_Datatype type = encodedDatatype(header, rep, repSize);
+    MPI_Recv(MPI_BOTTOM, 1, type, sender, tag, comm, status);
+    MPI_Type_free(&type);
+    rep[repSize] = '\0';
+
+    if (header[1] != repSize) {
+        delete [] rep;
+        throw CoinError("Size mismatch", "receiveSizeEncoded",
+                        "AlpsKnowledgeBrokerMPI");
     }
-    buf = new char [size];
 
-    // Third, receive MPI packed data and put in buf
-    MPI_Recv(buf, size, MPI_PACKED, sender, tag, comm, status);
+    // NOTE: Take over the memory of rep.
+    return new AlpsEncoded(header[0], repSize, rep);
 }
 
 //#############################################################################
@@ -3850,18 +4494,14 @@ AlpsKnowledgeBrokerMPI::receiveRampUpNode(int sender,
                                           MPI_Comm comm,
                                           MPI_Status* status)
 {
-    char* buf = 0;
-    int position = 0;
-
-    receiveSizeBuf(buf, sender, AlpsMsgNode, comm, status);
+    AlpsEncoded* encodedNode = receiveSizeEncoded(sender, AlpsMsgNode,
+                                                  comm, status);
 
     if (status->MPI_TAG == AlpsMsgFinishInit ) {
         //std::cout << "PROC: " << globalRank_
         //        <<" : rec AlpsMsgFinishInit... STOP INIT." << std::endl;
     }
     else if (status->MPI_TAG == AlpsMsgNode) {
-        AlpsEncoded* encodedNode = unpackEncoded(buf, position, comm);
-
 #ifdef NF_DEBUG
         std::cout << "WORKER: received and unpacked a node." << std::endl;
         std::cout << "WORKER: type() is " << encodedNode->type() << std::endl;
@@ -3878,6 +4518,17 @@ AlpsKnowledgeBrokerMPI::receiveRampUpNode(int sender,
         std::cout << "WORKER: finish just decoding node." << std::endl;
 #endif
 
+        double quality = ALPS_OBJ_MAX;
+        AlpsNodeStatus nodeStatus = AlpsNodeStatusCandidate;
+        encodedNode->readRep(quality);
+        encodedNode->readRep(nodeStatus);
+        if (isDominated(quality, nodeStatus)) {
+            // Pruned by the incumbent; no need to decode it.
+            ++nodeDiscardedNum_;
+            delete encodedNode;
+            return;
+        }
+
         AlpsTreeNode* node = dynamic_cast<AlpsTreeNode* >
             ( decoderObject(encodedNode->type())->decode(*encodedNode) );
 
@@ -3922,12 +4573,6 @@ AlpsKnowledgeBrokerMPI::receiveRampUpNode(int sender,
         throw CoinError("Unknow message type",
                         "receiveSizeNode()", "AlpsKnowledgeBrokerMPI");
     }
-
-    if (buf != 0) {
-        delete [] buf;
-        buf = 0;
-    }
-
 }
 
 //#############################################################################
@@ -3965,9 +4610,24 @@ AlpsKnowledgeBrokerMPI::receiveSubTree(char*& bufLarge,
         status->MPI_TAG == AlpsMsgSubTreeByMaster ||
         status->MPI_TAG == AlpsMsgSubTreeByWorker) {
 
-        AlpsEncoded* encodedST = unpackEncoded(bufLarge,
-                                               position,
-                                               MPI_COMM_WORLD);
+        int type = 0;
+        memcpy(&type, bufLarge, sizeof(int));
+
+        AlpsEncoded* encodedST = NULL;
+        if (type == sharedSubTreeMarker) {
+            encodedST = receiveSharedSubTree(status->MPI_SOURCE, bufLarge);
+        }
+        else {
+            encodedST = unpackEncoded(bufLarge, position, MPI_COMM_WORLD,
+                                      count);
+        }
+
+        if (encodedST->type() == AlpsKnowledgeTypeNode) {
+            // Open nodes sent by sendFrontier().
+            unpackFrontier(*encodedST);
+            delete encodedST;
+            return;
+        }
         AlpsSubTree* tempST = dynamic_cast<AlpsSubTree*>
             (const_cast<AlpsKnowledge *>
              (decoderObject(AlpsKnowledgeTypeSubTree)))->
@@ -3979,10 +4639,15 @@ AlpsKnowledgeBrokerMPI::receiveSubTree(char*& bufLarge,
         AlpsSubTree* subTree =
             dynamic_cast<AlpsSubTree* >(tempST->decode(*encodedST) );
 
-        assert(subTree->getNumNodes() > 0);
-
-        subTree->calculateQuality();
-        addKnowledge(AlpsKnowledgeTypeSubTree, subTree, subTree->getQuality());
+        if (subTree->getNumNodes() > 0) {
+            subTree->calculateQuality();
+            addKnowledge(AlpsKnowledgeTypeSubTree, subTree,
+                         subTree->getQuality());
+        }
+        else {
+            // All its open nodes were pruned by the incumbent.
+            delete subTree;
+        }
 
 
 #if 0
@@ -4016,20 +4681,58 @@ AlpsKnowledgeBrokerMPI::receiveSubTree(char*& bufLarge,
 //#############################################################################
 
 void
-AlpsKnowledgeBrokerMPI::sendSizeBuf(char*& buf,
-                                    int size,
-                                    int position,
-                                    const int target,
-                                    const int tag,
-                                    const MPI_Comm comm)
+AlpsKnowledgeBrokerMPI::unpackFrontier(AlpsEncoded& encoded)
 {
-    // If packing successfully, send buf size and buf to target
-    if (size >= 0) {
-        MPI_Send(&size, 1, MPI_INT, target, AlpsMsgSize, comm);
-        MPI_Send(buf, position, MPI_PACKED, target, tag, comm);
+    std::vector<AlpsSubTree*> subTrees;
+    dynamic_cast<const AlpsSubTree*>
+        (decoderObject(AlpsKnowledgeTypeSubTree))->
+        decodeFrontier(encoded, subTrees);
+
+    for (int k = 0; k < static_cast<int>(subTrees.size()); ++k) {
+        addKnowledge(AlpsKnowledgeTypeSubTree, subTrees[k],
+                     subTrees[k]->getQuality());
     }
-    else
-        throw CoinError("Msg size is < 0", "send", "AlpsKnowledgeBrokerMPI");
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::sendSizeEncoded(AlpsEncoded* enc,
+                                        const int target,
+                                        const int tag,
+                                        const MPI_Comm comm)
+{
+    int header[2];
+    header[0] = static_cast<int>(enc->type());
+    header[1] = static_cast<int>(enc->size());
+
+    if (header[1] < 0) {
+        throw CoinError("Msg size is < 0", "sendSizeEncoded",
+                        "AlpsKnowledgeBrokerMPI");
+    }
+
+    // Send the size, then header and representation straight from enc.
+    int size = static_cast<int>(sizeof(header)) + header[1];
+    MPI_Datatype type = encodedDatatype(header,
+                                        const_cast<char*>(enc->representation()),
+                                        header[1]);
+    MPI_Send(&size, 1, MPI_INT, target, AlpsMsgSize, comm);
+    MPI_Send(MPI_BOTTOM, 1, type, target, tag, comm);
+    MPI_Type_free(&type);
+}
+
+//#############################################################################
+
+// Encode a ramp-up node behind its quality and status, which
+// receiveRampUpNode() reads to skip nodes pruned by its incumbent.
+static AlpsEncoded*
+encodeRampUpNode(const AlpsTreeNode* node)
+{
+    AlpsEncoded* enc = new AlpsEncoded(AlpsKnowledgeTypeNode);
+    enc->writeRep(node->getQuality());
+    enc->writeRep(node->getStatus());
+    node->encode(enc);
+    return enc;
 }
 
 //#############################################################################
@@ -4039,26 +4742,16 @@ AlpsKnowledgeBrokerMPI::sendSizeBuf(char*& buf,
 void
 AlpsKnowledgeBrokerMPI::sendRampUpNode(const int receiver, MPI_Comm comm)
 {
-    char* buf = 0;
-    int size = 0;
-    int position = 0;
-
     AlpsTreeNode* node = dynamic_cast<AlpsTreeNode* >
         (rampUpSubTree_->nodePool()->getKnowledge().first);
 
-    AlpsEncoded* enc = node->encode();
+    AlpsEncoded* enc = encodeRampUpNode(node);
 
     rampUpSubTree_->nodePool()->popKnowledge();
 
     delete node;   // Since sending to other process
 
-    packEncoded(enc, buf, size, position, comm);
-    sendSizeBuf(buf, size, position, receiver, AlpsMsgNode, comm);
-
-    if (buf) {
-        delete [] buf;
-        buf = 0;
-    }
+    sendSizeEncoded(enc, receiver, AlpsMsgNode, comm);
 
     if (enc) {
         delete enc;
@@ -4109,75 +4802,413 @@ AlpsKnowledgeBrokerMPI::sendNodeModelGen(int receiver, int doUnitWork)
                  &position, MPI_COMM_WORLD);
     }
 
-    MPI_Send(largeBuffer_, position, MPI_PACKED, receiver, AlpsMsgNode,
-             MPI_COMM_WORLD);
+    MPI_Send(largeBuffer_, position, MPI_PACKED, receiver, AlpsMsgNode,
+             MPI_COMM_WORLD);
+
+}
+
+//#############################################################################
+
+// return sent or not.
+bool
+AlpsKnowledgeBrokerMPI::sendSubTree(const int receiver,
+                                    AlpsSubTree*& st,
+                                    int tag)
+{
+#ifdef NF_DEBUG
+    std::cout << "WORKER["<< globalRank_
+              << "]: start to donate a subtree to PROC " << receiver
+              << std::endl;
+#endif
+
+    bool success = false;
+
+    const double packStart = profileClock();
+    AlpsEncoded* enc = st->encode();
+    profilePack(tag, packStart);
+
+#if 0
+    std::cout << "WORKER["<< globalRank_
+              << "]: donor a subtree to PROC " << receiver
+              << "; encoded size = " << enc->size()
+              << "; largeSize_ = " << largeSize_ <<  std::endl;
+#endif
+
+    if (sendSharedSubTree(receiver, enc, tag)) {
+        success = true;
+    }
+    else {
+        // Send straight from enc, which is freed once the send completes.
+        // The receiver probes for the size, so the subtree need not fit
+        // in largeBuffer_.
+        postEncodedSend(receiver, tag, enc);
+        enc = 0;
+
+        success = true;
+    }
+
+    if (enc) {
+        delete enc;
+        enc = 0;                 // Allocated in encode()
+    }
+
+    return success;
+}
+
+//#############################################################################
+
+bool
+AlpsKnowledgeBrokerMPI::sendFrontier(const int receiver,
+                                     AlpsSubTree* st,
+                                     bool whole,
+                                     int tag)
+{
+    int numNodes = 0;
+
+    const double packStart = profileClock();
+    AlpsEncoded* enc = st->splitFrontier(numNodes, whole);
+    profilePack(tag, packStart);
+
+    if (enc == NULL) {
+        return false;
+    }
+
+    if (!sendSharedSubTree(receiver, enc, tag)) {
+        // Freed once the send completes.
+        postEncodedSend(receiver, tag, enc);
+        enc = 0;
+    }
+
+    if (enc) {
+        delete enc;
+        enc = 0;
+    }
+
+    return true;
+}
+
+//#############################################################################
+
+int
+AlpsKnowledgeBrokerMPI::acquireSendSlot()
+{
+    if (freeSendSlots_.empty()) {
+        AlpsPendingSend* send = new AlpsPendingSend;
+        send->encoded = NULL;
+        send->tag = -1;
+        send->postTime = 0.0;
+        sendSlots_.push_back(send);
+        return static_cast<int>(sendSlots_.size()) - 1;
+    }
+    int slot = freeSendSlots_.back();
+    freeSendSlots_.pop_back();
+    return slot;
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::postSend(int receiver,
+                                 int tag,
+                                 const char* buf,
+                                 int size)
+{
+    int slot = acquireSendSlot();
+    AlpsPendingSend* send = sendSlots_[slot];
+    send->buffer.resize(piggybackSize + size);
+    packPiggyback(&send->buffer[0]);
+    if (size > 0) {
+        memcpy(&send->buffer[piggybackSize], buf, size);
+    }
+    send->tag = tag;
+    send->postTime = profileClock();
+    profileSend(tag, size);
+    transport_->send(receiver, tag, &send->buffer[0], piggybackSize + size,
+                     NULL, 0, slot);
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::postEncodedSend(int receiver,
+                                        int tag,
+                                        AlpsEncoded* enc)
+{
+    int slot = acquireSendSlot();
+    AlpsPendingSend* send = sendSlots_[slot];
+    send->encoded = enc;
+    int header[2];
+    header[0] = static_cast<int>(enc->type());
+    header[1] = static_cast<int>(enc->size());
+    packPiggyback(send->head);
+    memcpy(send->head + piggybackSize, header, sizeof(header));
+    send->tag = tag;
+    send->postTime = profileClock();
+    profileSend(tag, static_cast<int>(sizeof(header)) + header[1]);
+    transport_->send(receiver, tag, send->head,
+                     piggybackSize + static_cast<int>(sizeof(header)),
+                     enc->representation(), header[1], slot);
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::progressSends()
+{
+    if (freeSendSlots_.size() == sendSlots_.size()) {
+        return;
+    }
+
+    doneSendSlots_.clear();
+    transport_->testSends(doneSendSlots_);
+
+    const double now = profileClock();
+    for (size_t k = 0; k < doneSendSlots_.size(); ++k) {
+        int slot = doneSendSlots_[k];
+        AlpsPendingSend* send = sendSlots_[slot];
+        if (profileMessages_ && send->tag >= 0) {
+            msgProfile_[send->tag].flightTime += now - send->postTime;
+        }
+        if (send->encoded) {
+            delete send->encoded;
+            send->encoded = NULL;
+        }
+        if (send->buffer.capacity() > static_cast<size_t>(largeSize_)) {
+            // Do not hold on to the memory of an unusually large message.
+            std::vector<char>().swap(send->buffer);
+        }
+        send->buffer.clear();
+        freeSendSlots_.push_back(slot);
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::setTransport(AlpsTransport* transport)
+{
+    if (freeSendSlots_.size() != sendSlots_.size()) {
+        throw CoinError("Sends in progress", "setTransport",
+                        "AlpsKnowledgeBrokerMPI");
+    }
+    if (processNum_ > 0) {
+        checkTransport(transport);
+    }
+    if (ownTransport_) {
+        delete transport_;
+    }
+    transport_ = transport;
+    ownTransport_ = false;
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::checkTransport(const AlpsTransport* transport) const
+{
+    // Ramp-up, termination checks and collectives address processes by
+    // their rank in MPI_COMM_WORLD, so the transport must use the same.
+    if (transport->rank() != globalRank_ ||
+        transport->size() != processNum_) {
+        throw CoinError("Transport ranks differ from MPI_COMM_WORLD",
+                        "checkTransport", "AlpsKnowledgeBrokerMPI");
+    }
+}
+
+//#############################################################################
+
+double
+AlpsKnowledgeBrokerMPI::profileClock() const
+{
+    return profileMessages_ ? AlpsGetTimeOfDay() : 0.0;
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::profileSend(int tag, int bytes)
+{
+    if (profileMessages_ && tag >= 0 && tag < AlpsMsgEndOfTags) {
+        msgProfile_[tag].sendCount += 1.0;
+        msgProfile_[tag].sendBytes += bytes;
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::profileRecv(int tag, int bytes, double start)
+{
+    if (profileMessages_ && tag >= 0 && tag < AlpsMsgEndOfTags) {
+        msgProfile_[tag].recvCount += 1.0;
+        msgProfile_[tag].recvBytes += bytes;
+        msgProfile_[tag].unpackTime += AlpsGetTimeOfDay() - start;
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::profilePack(int tag, double start)
+{
+    if (profileMessages_ && tag >= 0 && tag < AlpsMsgEndOfTags) {
+        msgProfile_[tag].packTime += AlpsGetTimeOfDay() - start;
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::profileWait(int tag, double start)
+{
+    if (profileMessages_ && tag >= 0 && tag < AlpsMsgEndOfTags) {
+        msgProfile_[tag].waitTime += AlpsGetTimeOfDay() - start;
+    }
+}
+
+//#############################################################################
 
+// Envelope rows count the envelopes themselves; the messages in them are
+// counted under their own tags as well.
+void
+AlpsKnowledgeBrokerMPI::writeMsgProfile(
+    std::ostream& os,
+    const std::vector<AlpsMsgProfile>& profile) const
+{
+    char line[256];
+    sprintf(line, "%-18s %10s %12s %10s %12s %9s %9s %9s %9s\n",
+            "Tag", "Sent", "SentBytes", "Recv", "RecvBytes",
+            "Pack", "Unpack", "Wait", "InFlight");
+    os << line;
+    for (size_t k = 0; k < profile.size(); ++k) {
+        const AlpsMsgProfile& p = profile[k];
+        if (p.sendCount == 0.0 && p.recvCount == 0.0 && p.waitTime == 0.0) {
+            continue;
+        }
+        sprintf(line, "%-18s %10.0f %12.0f %10.0f %12.0f %9.3f %9.3f %9.3f "
+                "%9.3f\n", msgTagNames[k], p.sendCount, p.sendBytes,
+                p.recvCount, p.recvBytes, p.packTime, p.unpackTime,
+                p.waitTime, p.flightTime);
+        os << line;
+    }
 }
 
 //#############################################################################
 
-// return sent or not.
-bool
-AlpsKnowledgeBrokerMPI::sendSubTree(const int receiver,
-                                    AlpsSubTree*& st,
-                                    int tag)
+void
+AlpsKnowledgeBrokerMPI::createSubTreeWindow()
 {
-#ifdef NF_DEBUG
-    std::cout << "WORKER["<< globalRank_
-              << "]: start to donate a subtree to PROC " << receiver
-              << std::endl;
-#endif
+    if (!model_->AlpsPar()->entry(AlpsParams::sharedSubTreeTransfer)) {
+        return;
+    }
 
-    bool success = false;
-    char* buf = 0;
-    int size = 0;
-    int position = 0;
+    // Only processes that donate subtrees need a segment.
+    MPI_Aint segmentSize = 0;
+    if (processType_ == AlpsProcessTypeWorker || hubWork_) {
+        segmentSize = sharedSubTreeOffset + largeSize_;
+    }
+    MPI_Win_allocate_shared(segmentSize, 1, MPI_INFO_NULL, nodeComm_,
+                            &subTreeSegment_, &subTreeWin_);
+    subTreeSegmentSize_ = static_cast<int>(segmentSize);
 
-    AlpsEncoded* enc = st->encode();
-    packEncoded(enc, buf, size, position, MPI_COMM_WORLD);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, subTreeWin_);
+    if (subTreeSegmentSize_ > 0) {
+        *reinterpret_cast<volatile int*>(subTreeSegment_) = 0;
+    }
+    MPI_Win_sync(subTreeWin_);
+    MPI_Barrier(nodeComm_);
+}
 
-#if 0
-    std::cout << "WORKER["<< globalRank_
-              << "]: donor a subtree to PROC " << receiver
-              << "; buf pos = " << position
-              << "; buf size = " << size
-              << "; largeSize_ = " << largeSize_ <<  std::endl;
-#endif
+//#############################################################################
 
-    assert(size > 0);
+void
+AlpsKnowledgeBrokerMPI::freeSubTreeWindow()
+{
+    if (subTreeWin_ != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(subTreeWin_);
+        MPI_Win_free(&subTreeWin_);
+        subTreeSegment_ = 0;
+        subTreeSegmentSize_ = 0;
+    }
+}
 
-    if (size <= largeSize_) {
-        // Attach buffer
-#if 0
-        //MPI_Bsend(buf, position, MPI_PACKED, receiver, tag, MPI_COMM_WORLD);
-        MPI_Send(buf, position, MPI_PACKED, receiver, tag, MPI_COMM_WORLD);
-#endif
-        if (!attachBuffer_) {
-            int attachSize = largeSize_* 6 + MPI_BSEND_OVERHEAD;
-            attachBuffer_ =  new char [attachSize];
-            MPI_Buffer_attach(attachBuffer_, attachSize);
-        }
-        MPI_Ibsend(buf, position, MPI_PACKED, receiver, tag,
-                   MPI_COMM_WORLD, &subTreeRequest_);
+//#############################################################################
 
-        success = true;
+bool
+AlpsKnowledgeBrokerMPI::sendSharedSubTree(int receiver,
+                                          AlpsEncoded* enc,
+                                          int tag)
+{
+    if (subTreeSegmentSize_ == 0 ||
+        nodeRankList_[receiver] == MPI_UNDEFINED) {
+        return false;
     }
-    else {
-        // msg size is larger than buffer size. Must not happen.
-        success = false;
-        std::cout << "WARNING: Subtree size is larger than message buffer size, will split it." << std::endl;
+
+    // Hubs forward subtrees sent by master to a worker, so the message
+    // must carry the subtree itself.
+    if (tag != AlpsMsgSubTree && tag != AlpsMsgSubTreeByWorker) {
+        return false;
     }
 
-    if (buf) {
-        delete [] buf;
-        buf = 0;
+    volatile int* busy = reinterpret_cast<volatile int*>(subTreeSegment_);
+    MPI_Win_sync(subTreeWin_);
+    if (*busy) {
+        // The previous receiver has not taken its subtree out yet.
+        return false;
     }
-    if (enc) {
-        delete enc;
-        enc = 0;                 // Allocated in encode()
+
+    int size = subTreeSegmentSize_ - sharedSubTreeOffset;
+    if (static_cast<int>(2 * sizeof(int)) + enc->size() > size) {
+        return false;
     }
 
-    return success;
+    int position = 0;
+    char* data = subTreeSegment_ + sharedSubTreeOffset;
+    packEncoded(enc, data, size, position, MPI_COMM_WORLD);
+    *busy = 1;
+    MPI_Win_sync(subTreeWin_);
+
+    // Tell the receiver where to find it.
+    int header[2];
+    header[0] = sharedSubTreeMarker;
+    header[1] = position;
+    postSend(receiver, tag, reinterpret_cast<const char*>(header),
+             static_cast<int>(sizeof(header)));
+
+    return true;
+}
+
+//#############################################################################
+
+AlpsEncoded*
+AlpsKnowledgeBrokerMPI::receiveSharedSubTree(int sender, char* buf)
+{
+    int header[2];
+    memcpy(header, buf, sizeof(header));
+
+    MPI_Aint segmentSize = 0;
+    int dispUnit = 0;
+    char* segment = NULL;
+    MPI_Win_shared_query(subTreeWin_, nodeRankList_[sender], &segmentSize,
+                         &dispUnit, &segment);
+
+    if (header[1] < 0 ||
+        sharedSubTreeOffset + header[1] > static_cast<int>(segmentSize)) {
+        throw CoinError("Shared subtree does not fit in segment",
+                        "receiveSharedSubTree", "AlpsKnowledgeBrokerMPI");
+    }
+
+    MPI_Win_sync(subTreeWin_);
+    int position = 0;
+    char* data = segment + sharedSubTreeOffset;
+    AlpsEncoded* encoded = unpackEncoded(data, position, MPI_COMM_WORLD,
+                                         header[1]);
+
+    // Hand the segment back to the donor.
+    *reinterpret_cast<volatile int*>(segment) = 0;
+    MPI_Win_sync(subTreeWin_);
+
+    return encoded;
 }
 
 //#############################################################################
@@ -4226,6 +5257,15 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
     MPI_Comm_rank(MPI_COMM_WORLD, &globalRank_);
     MPI_Comm_size(MPI_COMM_WORLD, &processNum_);
 
+    // Messages of the search go over MPI unless a transport was set.
+    if (!transport_) {
+        transport_ = new AlpsTransportMPI(MPI_COMM_WORLD);
+        ownTransport_ = true;
+    }
+    else {
+        checkTransport(transport_);
+    }
+
     // CORRECTME
     // NOTE: masterRank_ is 0 or 1 (debug). Must smaller than cluster size.
     masterRank_ = 0;
@@ -4382,28 +5422,94 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
 
     timer_.limit_ = model_->AlpsPar()->entry(AlpsParams::timeLimit);
 
-    while(true) {
-        if (hubNum_ > 0) {
-            userClusterSize_ = 1;
-            while (userClusterSize_ * hubNum_ < processNum_) {
-                ++userClusterSize_;
+    // Starting values; tuneBalance() may change them during the search.
+    donorThreshold_ = model_->AlpsPar()->entry(AlpsParams::donorThreshold);
+    receiverThreshold_ =
+        model_->AlpsPar()->entry(AlpsParams::receiverThreshold);
+    needWorkThreshold_ =
+        model_->AlpsPar()->entry(AlpsParams::needWorkThreshold);
+    changeWorkThreshold_ =
+        model_->AlpsPar()->entry(AlpsParams::changeWorkThreshold);
+
+    const bool topologyClusters =
+        model_->AlpsPar()->entry(AlpsParams::topologyClusters);
+
+    //------------------------------------------------------
+    // Find the processes on the same shared memory node.
+    //------------------------------------------------------
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, key,
+                        MPI_INFO_NULL, &nodeComm_);
+
+    nodeRankList_ = new int [processNum_];
+    {
+        MPI_Group worldGroup, nodeGroup;
+        std::vector<int> worldRanks(processNum_);
+        for (i = 0; i < processNum_; ++i) {
+            worldRanks[i] = i;
+        }
+        MPI_Comm_group(MPI_COMM_WORLD, &worldGroup);
+        MPI_Comm_group(nodeComm_, &nodeGroup);
+        MPI_Group_translate_ranks(worldGroup, processNum_, &worldRanks[0],
+                                  nodeGroup, nodeRankList_);
+        MPI_Group_free(&nodeGroup);
+        MPI_Group_free(&worldGroup);
+    }
+
+    // The cluster of each process; clusters are numbered by their hubs.
+    clusterIndexList_ = new int [processNum_];
+
+    if (topologyClusters) {
+        // One cluster per shared memory node, named by its lowest rank.
+        int nodeLeader = globalRank_;
+        for (i = 0; i < processNum_; ++i) {
+            if (nodeRankList_[i] == 0) {
+                nodeLeader = i;
+                break;
             }
-            // [0,...,cluSize-1] in group 1
-            color = globalRank_ / userClusterSize_;
         }
-        else {
-            std::cout << "hubNum_ <= 0" << std::endl;
-            throw CoinError("hubNum_ <= 0",
-                            "initSearch",
-                            "AlpsKnowledgeBrokerMPI");
+        MPI_Allgather(&nodeLeader, 1, MPI_INT, clusterIndexList_, 1, MPI_INT,
+                      MPI_COMM_WORLD);
+
+        // A leader comes before the other processes on its node.
+        hubNum_ = 0;
+        for (i = 0; i < processNum_; ++i) {
+            if (clusterIndexList_[i] == i) {
+                clusterIndexList_[i] = hubNum_++;
+            }
+            else {
+                clusterIndexList_[i] = clusterIndexList_[clusterIndexList_[i]];
+            }
         }
+        color = clusterIndexList_[globalRank_];
+    }
+    else {
+        while(true) {
+            if (hubNum_ > 0) {
+                userClusterSize_ = 1;
+                while (userClusterSize_ * hubNum_ < processNum_) {
+                    ++userClusterSize_;
+                }
+                // [0,...,cluSize-1] in group 1
+                color = globalRank_ / userClusterSize_;
+            }
+            else {
+                std::cout << "hubNum_ <= 0" << std::endl;
+                throw CoinError("hubNum_ <= 0",
+                                "initSearch",
+                                "AlpsKnowledgeBrokerMPI");
+            }
 
-        // more than 1 proc in the last cluser
-        if (processNum_- userClusterSize_ * (hubNum_ - 1) > 1) {
-            break;
+            // more than 1 proc in the last cluser
+            if (processNum_- userClusterSize_ * (hubNum_ - 1) > 1) {
+                break;
+            }
+            else {
+                --hubNum_;
+            }
         }
-        else {
-            --hubNum_;
+        for (i = 0; i < processNum_; ++i) {
+            clusterIndexList_[i] = i / userClusterSize_;
         }
     }
     if ( (globalRank_ == masterRank_) && (msgLevel_ > 0) ) {
@@ -4411,6 +5517,26 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
             << hubNum_ << CoinMessageEol;
     }
 
+    //------------------------------------------------------
+    // Rank of every process in its cluster. The first process of a
+    // cluster is its hub.
+    //------------------------------------------------------
+
+    hubRanks_ = new int [hubNum_];
+    clusterRankList_ = new int [processNum_];
+    std::vector<int> clusterCount(hubNum_, 0);
+    for (i = 0; i < processNum_; ++i) {
+        int c = clusterIndexList_[i];
+        if (clusterCount[c] == 0) {
+            hubRanks_[c] = i;
+        }
+        clusterRankList_[i] = clusterCount[c]++;
+    }
+    if (topologyClusters) {
+        userClusterSize_ = *std::max_element(clusterCount.begin(),
+                                             clusterCount.end());
+    }
+
     //------------------------------------------------------
     // Create clusterComm_.
     //------------------------------------------------------
@@ -4419,6 +5545,13 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
     MPI_Comm_rank(clusterComm_, &clusterRank_);
     MPI_Comm_size(clusterComm_, &clusterSize_);
 
+    clusterRanks_ = new int [clusterSize_];
+    for (i = 0; i < processNum_; ++i) {
+        if (clusterIndexList_[i] == color) {
+            clusterRanks_[clusterRankList_[i]] = i;
+        }
+    }
+
 #if 0
     std::cout << "+++ masterRank_ = " << masterRank_
               << ", clusterSize_ = " << clusterSize_
@@ -4429,12 +5562,6 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
     // Create hubGroup_ and hubComm_.
     //------------------------------------------------------
 
-    hubRanks_ = new int [hubNum_];
-    int k = 0;
-    for (i = 0; i < processNum_; i += userClusterSize_) {
-        hubRanks_[k++] = i + masterRank_;
-    }
-
     MPI_Group worldGroup;
     MPI_Comm_group(MPI_COMM_WORLD, &worldGroup);
     MPI_Group_incl(worldGroup, hubNum_, hubRanks_, &hubGroup_);
@@ -4442,26 +5569,17 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
 
     //------------------------------------------------------
     // Allcoate index, classify process types, set up knowledge pools
-    //   Master  :  [0, INT_MAX/5]
-    //   Others  :  divide [INT_MAX/5 + 1, INT_MAX]
+    //   Every process numbers its nodes with its rank in the high bits,
+    //   see AlpsNodeIndex_t.
     //------------------------------------------------------
 
-    int workerDown = -1, workerUp = -1;
-    int masterDown = 0;
-    int masterUp = static_cast<int>(ALPS_INT_MAX / 5);
-    int workerIndexR = static_cast<int>( static_cast<double>(ALPS_INT_MAX - masterUp)/(processNum_-1));
-    workerIndexR -= 2;  // leave some buffer
-
-    if (globalRank_ < masterRank_) {
-        workerDown = masterUp + globalRank_ * workerIndexR;
-        workerUp = workerDown + workerIndexR;
-    }
-    else if (globalRank_ > masterRank_) {
-        workerDown = masterUp + (globalRank_-1) * workerIndexR;
-        workerUp = workerDown + workerIndexR;
-    }
-
-    masterIndexBatch_ = masterUp / (processNum_ * 2);
+    const AlpsNodeIndex_t indexDown =
+        static_cast<AlpsNodeIndex_t>(globalRank_) << ALPS_NODE_INDEX_LOCAL_BITS;
+    const AlpsNodeIndex_t indexUp =
+        indexDown + ((static_cast<AlpsNodeIndex_t>(1) <<
+                      ALPS_NODE_INDEX_LOCAL_BITS) - 1);
+    setNextNodeIndex(indexDown);
+    setMaxNodeIndex(indexUp);
 
     //------------------------------------------------------
     // Decide process type.
@@ -4469,33 +5587,21 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
 
     if (globalRank_ == masterRank_) {
         processType_ = AlpsProcessTypeMaster;
-        setNextNodeIndex(masterDown);
-        setMaxNodeIndex(masterUp);
-
-#if 0
-        std::cout << "masterDown = " << masterDown
-                  << "; masterUp = " << masterUp
-                  << "; workerDown = " << workerDown
-                  << "; workerUp = " << workerUp
-                  << "; masterIndexBatch_ = " << masterIndexBatch_
-                  << std::endl;
-#endif
     }
-    else if ( (globalRank_ % userClusterSize_) == masterRank_ ) {
+    else if (clusterRank_ == masterRank_) {
         processType_ = AlpsProcessTypeHub;
-        setNextNodeIndex(workerDown);
-        setMaxNodeIndex(workerUp);
     }
     else {
         processType_ = AlpsProcessTypeWorker;
-        setNextNodeIndex(workerDown);
-        setMaxNodeIndex(workerUp);
     }
 
     // Determine if hubs process nodes.
     int hubWorkClusterSizeLimit =
         model_->AlpsPar()->entry(AlpsParams::hubWorkClusterSizeLimit);
-    if (userClusterSize_ > hubWorkClusterSizeLimit) {
+    // Clusters formed by node may differ in size; each decides for itself.
+    const int hubWorkClusterSize =
+        topologyClusters ? clusterSize_ : userClusterSize_;
+    if (hubWorkClusterSize > hubWorkClusterSizeLimit) {
         hubWork_ = false;
     }
     else {
@@ -4511,7 +5617,7 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
         if (i == masterRank_) {
             processTypeList_[i] = AlpsProcessTypeMaster;
         }
-        else if ( (i % userClusterSize_) == masterRank_) {
+        else if (clusterRankList_[i] == masterRank_) {
             processTypeList_[i] = AlpsProcessTypeHub;
         }
         else {
@@ -4526,8 +5632,7 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
     if (processType_ == AlpsProcessTypeWorker ||
         processType_ == AlpsProcessTypeHub) {
 
-        myHubRank_ =
-            (globalRank_ / userClusterSize_) * userClusterSize_ + masterRank_;
+        myHubRank_ = hubRanks_[color];
 
 #ifdef NF_DEBUG
         std::cout << "PROCESS[" << globalRank_ << "] : my hub rank = "
@@ -4535,6 +5640,74 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
 #endif
     }
 
+    //------------------------------------------------------
+    // Group the hubs under sub-masters. The master leads the first
+    // group and balances the groups against each other.
+    //------------------------------------------------------
+
+    int subMasterNum = model_->AlpsPar()->entry(AlpsParams::subMasterNum);
+    subMasterNum = CoinMax(0, CoinMin(subMasterNum, hubNum_ - 1));
+    hubGroupSize_ = (hubNum_ + subMasterNum) / (subMasterNum + 1);
+    if (hubGroupSize_ < hubNum_ &&
+        !model_->AlpsPar()->entry(AlpsParams::decentralTermination)) {
+        // Sub-masters only aggregate the periodic reports, so the
+        // centralized termination check can not run through them.
+        if (globalRank_ == masterRank_ && msgLevel_ > 0) {
+            messageHandler()->message(ALPS_SUBMASTER_DECENTRAL_TERM,
+                                      messages()) << CoinMessageEol;
+        }
+        model_->AlpsPar()->setEntry(AlpsParams::decentralTermination, true);
+    }
+
+    const int myGroup = color / hubGroupSize_;
+    const int groupLeader = hubRanks_[myGroup * hubGroupSize_];
+    subMaster_ = (processType_ == AlpsProcessTypeHub &&
+                  groupLeader == globalRank_);
+    parentRank_ = subMaster_ ? masterRank_ : groupLeader;
+
+    childRanks_.clear();
+    if (processType_ == AlpsProcessTypeMaster || subMaster_) {
+        const int groupEnd = CoinMin(hubNum_, (myGroup + 1) * hubGroupSize_);
+        for (i = myGroup * hubGroupSize_; i < groupEnd; ++i) {
+            childRanks_.push_back(hubRanks_[i]);
+        }
+        if (processType_ == AlpsProcessTypeMaster) {
+            for (i = hubGroupSize_; i < hubNum_; i += hubGroupSize_) {
+                childRanks_.push_back(hubRanks_[i]);
+            }
+        }
+    }
+
+    //------------------------------------------------------
+    // Set up sharing of generated model knowledge.
+    //------------------------------------------------------
+
+    knowledgeTopology_ =
+        model_->AlpsPar()->entry(AlpsParams::knowledgeTopology);
+    knowledgeBudget_ = model_->AlpsPar()->entry(AlpsParams::knowledgeBudget);
+    knowledgeBudgetPeriod_ =
+        model_->AlpsPar()->entry(AlpsParams::knowledgeBudgetPeriod);
+    knowledgeDedupSize_ =
+        model_->AlpsPar()->entry(AlpsParams::knowledgeDedupSize);
+    knowledgePeriodStart_ = AlpsGetTimeOfDay();
+    knowledgeBytesSent_ = 0;
+    knowledgeRandom_.seed(globalRank_ + 1);
+
+    //------------------------------------------------------
+    // Set up the received model. Workers that do not take part in ramp-up
+    // do it while the master ramps up, see workerMain().
+    //------------------------------------------------------
+
+    if (deferSetupSelf_) {
+        const int staticBalanceScheme =
+            model_->AlpsPar()->entry(AlpsParams::staticBalanceScheme);
+        if (processType_ != AlpsProcessTypeWorker ||
+            staticBalanceScheme != AlpsRootInit) {
+            model_->setupSelf();
+            deferSetupSelf_ = false;
+        }
+    }
+
     //------------------------------------------------------
     // Set up knowledge pools.
     //------------------------------------------------------
@@ -4560,6 +5733,63 @@ AlpsKnowledgeBrokerMPI::initializeSearch(int argc,
     subTreeTimer_.setClockType(clockType);
     tempTimer_.setClockType(clockType);
 
+    //------------------------------------------------------
+    // Open checkpoint log if required, one per process.
+    //------------------------------------------------------
+
+    std::string checkpointFile =
+        model_->AlpsPar()->entry(AlpsParams::checkpointFile);
+    if (checkpointFile != "NONE") {
+        char rankStr[32];
+        sprintf(rankStr, ".%d", globalRank_);
+        // The parallel search always starts from the root, so an old log
+        // is truncated rather than mixed with the records of this run.
+        if (model_->AlpsPar()->entry(AlpsParams::checkpointRestart) &&
+            globalRank_ == masterRank_ && msgLevel_ > 0) {
+            messageHandler()->message(ALPS_CHECKPOINT_NO_RESTART, messages())
+                << checkpointFile.c_str() << CoinMessageEol;
+        }
+        setupCheckpoint(checkpointFile + rankStr, false);
+    }
+
+    //------------------------------------------------------
+    // Open solution stream if required, one per process.
+    //------------------------------------------------------
+
+    std::string solutionStreamFile =
+        model_->AlpsPar()->entry(AlpsParams::solutionStreamFile);
+    if (solutionStreamFile != "NONE") {
+        char rankStr[32];
+        sprintf(rankStr, ".%d", globalRank_);
+        setupSolutionStream(solutionStreamFile + rankStr);
+    }
+
+    //------------------------------------------------------
+    // Open search tree event log if required, one per process.
+    //------------------------------------------------------
+
+    std::string eventLogFile =
+        model_->AlpsPar()->entry(AlpsParams::eventLogFile);
+    if (eventLogFile != "NONE") {
+        char rankStr[32];
+        sprintf(rankStr, ".%d", globalRank_);
+        setupEventLog(eventLogFile + rankStr);
+    }
+
+    //------------------------------------------------------
+    // Set up the message profile if required.
+    //------------------------------------------------------
+
+    profileMessages_ =
+        model_->AlpsPar()->entry(AlpsParams::profileMessages) ||
+        model_->AlpsPar()->entry(AlpsParams::msgProfileFile) != "NONE";
+    if (profileMessages_) {
+        assert(sizeof(msgTagNames) / sizeof(msgTagNames[0]) ==
+               AlpsMsgEndOfTags);
+        AlpsMsgProfile zero = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        msgProfile_.assign(AlpsMsgEndOfTags, zero);
+    }
+
     //------------------------------------------------------
     // Allocate memory. TODO.
     //------------------------------------------------------
@@ -4589,6 +5819,8 @@ void AlpsKnowledgeBrokerMPI::rootSearch(AlpsTreeNode* root)
 
     timer_.start();
 
+    createIncumbentWindow();
+
     //------------------------------------------------------
     // Call main functions.
     //------------------------------------------------------
@@ -4611,6 +5843,12 @@ void AlpsKnowledgeBrokerMPI::rootSearch(AlpsTreeNode* root)
     //------------------------------------------------------
 
     MPI_Barrier(MPI_COMM_WORLD);
+
+    // All updates are complete; agree on the owner of the incumbent.
+    readIncumbent();
+    freeIncumbentWindow();
+    freeSubTreeWindow();
+
     collectBestSolution(masterRank_);
 
     // Search to end.
@@ -4647,8 +5885,7 @@ AlpsKnowledgeBrokerMPI::masterForceHubTerm()
     forceTerminate_ = true;
     for (int i = 0; i < hubNum_; ++i) {
         if (i != masterRank_) {
-            MPI_Send(buf, 0, MPI_PACKED, hubRanks_[i],
-                     AlpsMsgForceTerm, MPI_COMM_WORLD);
+            postSend(hubRanks_[i], AlpsMsgForceTerm, buf, 0);
             incSendCount("masterForceHubTerm");
         }
     }
@@ -4664,8 +5901,7 @@ AlpsKnowledgeBrokerMPI::hubForceWorkerTerm()
     forceTerminate_ = true;
     for (int i = 0; i < clusterSize_; ++i) {
         if (i != clusterRank_) {
-            MPI_Send(buf, 0, MPI_PACKED, globalRank_+i,
-                     AlpsMsgForceTerm, MPI_COMM_WORLD);
+            postSend(clusterRanks_[i], AlpsMsgForceTerm, buf, 0);
             incSendCount("hubForceWorkerTerm");
         }
     }
@@ -4699,9 +5935,12 @@ AlpsKnowledgeBrokerMPI::changeWorkingSubTree(double & changeWorkThreshold)
                 addKnowledge(AlpsKnowledgeTypeSubTree, tempST, curQuality);
                 ++(psStats_.subtreeChange_);
 
-                // Avoid too much change.
+                // Avoid too much change, within the bound tuneBalance()
+                // also keeps.
                 if (psStats_.subtreeChange_ / 10 == 0) {
-                    changeWorkThreshold *= 2.0;
+                    changeWorkThreshold = CoinMin(16.0 * model_->AlpsPar()->
+                        entry(AlpsParams::changeWorkThreshold),
+                        2.0 * changeWorkThreshold);
                 }
 #if 0
                 std::cout << "Process[" << globalRank_
@@ -4719,6 +5958,177 @@ AlpsKnowledgeBrokerMPI::changeWorkingSubTree(double & changeWorkThreshold)
 
 //#############################################################################
 
+void
+AlpsKnowledgeBrokerMPI::tuneBalance(double idleTime)
+{
+    if (!model_->AlpsPar()->entry(AlpsParams::selfTuneBalance)) {
+        return;
+    }
+
+    int i;
+    const bool isHub = (processType_ != AlpsProcessTypeWorker);
+
+    //------------------------------------------------------
+    // Sample this round. A hub records how many of its workers are short
+    // of work, unless the cluster has no work left to balance.
+    //------------------------------------------------------
+
+    const double zeroLoad = model_->AlpsPar()->entry(AlpsParams::zeroLoad);
+    if (isHub && clusterSize_ > 1 && clusterWorkQuantity_ >= zeroLoad) {
+        int numShort = 0;
+        for (i = 0; i < clusterSize_; ++i) {
+            if (i != clusterRank_ &&
+                workerWorkQuantities_[i] <= needWorkThreshold_) {
+                ++numShort;
+            }
+        }
+        tuneStarved_ += numShort / (clusterSize_ - 1.0);
+    }
+    ++tuneRounds_;
+
+    //------------------------------------------------------
+    // Act once per epoch of ten balance periods.
+    //------------------------------------------------------
+
+    double period = 0.0;
+    if (processType_ == AlpsProcessTypeMaster) {
+        period = masterBalancePeriod_ * balancePeriodScale_;
+    }
+    else if (isHub) {
+        period = hubReportPeriod_ * balancePeriodScale_;
+    }
+    else {
+        period = computeBalancePeriod(false, 0.0, nodeProcessingTime_);
+    }
+
+    const double now = timer_.getWallClockTime();
+    if (tuneStartTime_ >= 0.0 && now - tuneStartTime_ < 10.0 * period) {
+        return;
+    }
+
+    if (tuneStartTime_ >= 0.0) {
+        const double epoch = now - tuneStartTime_;
+        bool changed = false;
+
+        if (isHub) {
+            //----------------------------------------------
+            // Workers that run dry between rounds need a shorter period.
+            // When no one is short of work and reports keep the hub busy,
+            // balance less often and only for larger quality gaps.
+            // Otherwise drift back to the parameter values.
+            //----------------------------------------------
+
+            const double donorSh =
+                model_->AlpsPar()->entry(AlpsParams::donorThreshold);
+            const double receiverSh =
+                model_->AlpsPar()->entry(AlpsParams::receiverThreshold);
+            const double shortOfWork = tuneStarved_ / tuneRounds_;
+            const double msgRate = tuneMsgCount_ /
+                (tuneRounds_ * CoinMax(clusterSize_ - 1.0, 1.0));
+
+            const double oldScale = balancePeriodScale_;
+            const double oldDonor = donorThreshold_;
+            const double oldReceiver = receiverThreshold_;
+
+            if (shortOfWork > 0.25) {
+                balancePeriodScale_ = CoinMax(0.1, 0.5 * balancePeriodScale_);
+            }
+            else if (shortOfWork == 0.0 && msgRate > 2.0) {
+                balancePeriodScale_ = CoinMin(10.0, 1.5 * balancePeriodScale_);
+                donorThreshold_ = CoinMin(0.5, 1.5 * donorThreshold_);
+                receiverThreshold_ = CoinMin(0.5, 1.5 * receiverThreshold_);
+            }
+            else if (shortOfWork == 0.0) {
+                if (balancePeriodScale_ > 1.0) {
+                    balancePeriodScale_ =
+                        CoinMax(1.0, 0.8 * balancePeriodScale_);
+                }
+                else {
+                    balancePeriodScale_ =
+                        CoinMin(1.0, 1.25 * balancePeriodScale_);
+                }
+                donorThreshold_ = CoinMax(donorSh, 0.8 * donorThreshold_);
+                receiverThreshold_ =
+                    CoinMax(receiverSh, 0.8 * receiverThreshold_);
+            }
+
+            changed = (balancePeriodScale_ != oldScale ||
+                       donorThreshold_ != oldDonor ||
+                       receiverThreshold_ != oldReceiver);
+
+            if (changed && ((processType_ == AlpsProcessTypeMaster) ?
+                            (msgLevel_ > 2) : (hubMsgLevel_ > 2))) {
+                messageHandler()->message(ALPS_LOADBAL_TUNE_HUB, messages())
+                    << globalRank_ << period * balancePeriodScale_ / oldScale
+                    << donorThreshold_ << receiverThreshold_
+                    << shortOfWork << msgRate << CoinMessageEol;
+            }
+        }
+        else {
+            //----------------------------------------------
+            // An idle worker asks for work earlier, before it runs out.
+            // If most requests come back empty and little time is lost,
+            // it asks later. Frequent subtree changes raise the change
+            // threshold; none let it return to the parameter value.
+            //----------------------------------------------
+
+            const double needSh =
+                model_->AlpsPar()->entry(AlpsParams::needWorkThreshold);
+            const double changeSh =
+                model_->AlpsPar()->entry(AlpsParams::changeWorkThreshold);
+            const double idle = (idleTime - tuneIdleTime_) / epoch;
+            const int numChange =
+                psStats_.subtreeChange_ - tunePsStats_.subtreeChange_;
+
+            const double oldNeed = needWorkThreshold_;
+            const double oldChange = changeWorkThreshold_;
+
+            if (idle > 0.1) {
+                needWorkThreshold_ =
+                    CoinMin(16.0 * needSh, 2.0 * needWorkThreshold_);
+            }
+            else if (idle < 0.02 && tuneWorkEmpty_ > tuneWorkRecv_) {
+                needWorkThreshold_ =
+                    CoinMax(0.25 * needSh, 0.5 * needWorkThreshold_);
+            }
+
+            if (numChange > 10) {
+                changeWorkThreshold_ =
+                    CoinMin(16.0 * changeSh, 2.0 * changeWorkThreshold_);
+            }
+            else if (numChange == 0) {
+                changeWorkThreshold_ =
+                    CoinMax(changeSh, 0.5 * changeWorkThreshold_);
+            }
+
+            changed = (needWorkThreshold_ != oldNeed ||
+                       changeWorkThreshold_ != oldChange);
+
+            if (changed && workerMsgLevel_ > 2) {
+                messageHandler()->message(ALPS_LOADBAL_TUNE_WORKER, messages())
+                    << globalRank_ << needWorkThreshold_
+                    << changeWorkThreshold_ << idle
+                    << tuneWorkRecv_ << tuneWorkEmpty_ << CoinMessageEol;
+            }
+        }
+    }
+
+    //------------------------------------------------------
+    // Start the next epoch.
+    //------------------------------------------------------
+
+    tuneStartTime_ = now;
+    tuneIdleTime_ = idleTime;
+    tunePsStats_ = psStats_;
+    tuneMsgCount_ = 0;
+    tuneRounds_ = 0;
+    tuneStarved_ = 0.0;
+    tuneWorkRecv_ = 0;
+    tuneWorkEmpty_ = 0;
+}
+
+//#############################################################################
+
 void
 AlpsKnowledgeBrokerMPI::searchLog()
 {
@@ -4817,6 +6227,27 @@ AlpsKnowledgeBrokerMPI::searchLog()
     MPI_Gather(&(psStats_.subtreeChange_), 1, MPI_INT, subtreeChange, 1,
                MPI_INT, masterRank_, MPI_COMM_WORLD);
 
+    std::vector<AlpsMsgProfile> msgTotal;
+    if (profileMessages_) {
+        // AlpsMsgProfile holds only doubles.
+        const int numFields = static_cast<int>(msgProfile_.size() *
+                                               sizeof(AlpsMsgProfile) /
+                                               sizeof(double));
+        msgTotal.resize(msgProfile_.size());
+        MPI_Reduce(&msgProfile_[0].sendCount, &msgTotal[0].sendCount,
+                   numFields, MPI_DOUBLE, MPI_SUM, masterRank_,
+                   MPI_COMM_WORLD);
+
+        std::string msgProfileFile =
+            model_->AlpsPar()->entry(AlpsParams::msgProfileFile);
+        if (msgProfileFile != "NONE") {
+            char rankStr[32];
+            sprintf(rankStr, ".%d", globalRank_);
+            std::ofstream os((msgProfileFile + rankStr).c_str());
+            writeMsgProfile(os, msgProfile_);
+        }
+    }
+
     if (processType_ == AlpsProcessTypeMaster) {
         int numWorkers = 0;   // Number of process are processing nodes.
 
@@ -5290,7 +6721,19 @@ AlpsKnowledgeBrokerMPI::searchLog()
             std::cout << "Subtree change = " << sumSubtreeChange
                       << std::endl;
 
-            std::cout << "----------------------------------" << std::endl;
+            std::cout << "----------------------------------" << std::endl;
+
+            //----------------------------------------------
+            // Message traffic.
+            //----------------------------------------------
+
+            if (profileMessages_) {
+                std::cout << "Message traffic of all processes (seconds):"
+                          << std::endl;
+                writeMsgProfile(std::cout, msgTotal);
+                std::cout << "----------------------------------"
+                          << std::endl;
+            }
 
             //----------------------------------------------
             // Overall.
@@ -5448,24 +6891,29 @@ AlpsKnowledgeBrokerMPI::init()
     processNum_ = 0;
     globalRank_ = -1;
     clusterComm_ = MPI_COMM_NULL;
+    nodeComm_ = MPI_COMM_NULL;
     hubComm_ = MPI_COMM_NULL;
     hubGroup_ = MPI_GROUP_NULL;
     clusterSize_ = 0;
     userClusterSize_ = 0;
     clusterRank_ = -1;
     hubRanks_ = 0;
+    clusterRanks_ = 0;
+    clusterIndexList_ = 0;
+    clusterRankList_ = 0;
+    nodeRankList_ = 0;
     myHubRank_ = -1;
     masterRank_ = -1;
+    hubGroupSize_ = 0;
+    subMaster_ = false;
+    parentRank_ = -1;
     processType_ = AlpsProcessTypeAny;
     processTypeList_ = NULL;
     hubWork_ = false;
-    subTreeRequest_ = MPI_REQUEST_NULL;
-    solRequestL_ = MPI_REQUEST_NULL;
-    solRequestR_ = MPI_REQUEST_NULL;
-    modelKnowRequestL_ = MPI_REQUEST_NULL;
-    modelKnowRequestR_ = MPI_REQUEST_NULL;
-    forwardRequestL_ = MPI_REQUEST_NULL;
-    forwardRequestR_ = MPI_REQUEST_NULL;
+    incumbentWin_ = MPI_WIN_NULL;
+    subTreeWin_ = MPI_WIN_NULL;
+    subTreeSegment_ = 0;
+    subTreeSegmentSize_ = 0;
     incumbentValue_ = ALPS_INC_MAX;
     incumbentID_ = 0;
     updateIncumbent_ = false;
@@ -5490,11 +6938,19 @@ AlpsKnowledgeBrokerMPI::init()
     hubNodeProcesseds_ = 0;
     sendCount_ = 0;
     recvCount_ = 0;
+    totalSendCount_ = 0;
+    totalRecvCount_ = 0;
+    termRequest_ = MPI_REQUEST_NULL;
+    termPrevious_[0] = 1;    // No previous wave.
+    termPrevious_[1] = termPrevious_[2] = 0;
+    numTermWaves_ = 0;
+    stealPending_ = false;
+    stealDelay_ = 0.0;
+    stealNextTime_ = 0.0;
     clusterSendCount_ = 0;
     clusterRecvCount_ = 0;
     systemSendCount_ = 0;
     systemRecvCount_ = 0;
-    masterIndexBatch_ = 0;
     rampUpTime_ = 0.0;
     rampDownTime_ = 0.0;
     idleTime_ = 0.0;
@@ -5524,12 +6980,37 @@ AlpsKnowledgeBrokerMPI::init()
     hubReportPeriod_ = 0.01;
     modelGenID_ = -1;
     modelGenPos_ = -1;
+    modelGenHops_ = 0;
+    profileMessages_ = false;
+    transport_ = NULL;
+    ownTransport_ = false;
+    knowledgeTopology_ = AlpsKnowledgeTree;
+    knowledgeBudget_ = 0;
+    knowledgeBudgetPeriod_ = 1.0;
+    knowledgeBytesSent_ = 0;
+    knowledgePeriodStart_ = 0.0;
+    knowledgeDedupSize_ = 0;
 
     rampUpSubTree_ = 0;
     unitWorkNodes_ = 0;
     haltSearch_ = false;
+    deferSetupSelf_ = false;
 
     userBalancePeriod_ = false;
+
+    donorThreshold_ = 0.0;
+    receiverThreshold_ = 0.0;
+    needWorkThreshold_ = 0.0;
+    changeWorkThreshold_ = 0.0;
+    balancePeriodScale_ = 1.0;
+    tuneStartTime_ = -1.0;
+    tuneIdleTime_ = 0.0;
+    tunePsStats_ = psStats_;
+    tuneMsgCount_ = 0;
+    tuneRounds_ = 0;
+    tuneStarved_ = 0.0;
+    tuneWorkRecv_ = 0;
+    tuneWorkEmpty_ = 0;
 }
 
 //#############################################################################
@@ -5546,6 +7027,18 @@ AlpsKnowledgeBrokerMPI::~AlpsKnowledgeBrokerMPI()
     if (hubRanks_) {
         delete [] hubRanks_; hubRanks_ = 0;
     }
+    if (clusterRanks_) {
+        delete [] clusterRanks_; clusterRanks_ = 0;
+    }
+    if (clusterIndexList_) {
+        delete [] clusterIndexList_; clusterIndexList_ = 0;
+    }
+    if (clusterRankList_) {
+        delete [] clusterRankList_; clusterRankList_ = 0;
+    }
+    if (nodeRankList_) {
+        delete [] nodeRankList_; nodeRankList_ = 0;
+    }
     //	std::cout << "Here2 -- " << globalRank_ << std::endl;
     if (processTypeList_) {
         delete [] processTypeList_; processTypeList_ = NULL;
@@ -5603,8 +7096,35 @@ AlpsKnowledgeBrokerMPI::~AlpsKnowledgeBrokerMPI()
         delete rampUpSubTree_;
         rampUpSubTree_ = 0;
     }
+    // Every process has left the search at the barrier that ends it, so a
+    // send not matched by now never will be: cancel it. Then discard the
+    // messages nobody will process, so that MPI is finalized with no
+    // communication pending.
+    if (transport_) {
+        doneSendSlots_.clear();
+        transport_->cancelSends(doneSendSlots_);
+        MPI_Barrier(MPI_COMM_WORLD);
+        int source, tag, count;
+        std::vector<char> discard;
+        while (transport_->probe(source, tag, count)) {
+            discard.resize(count + 1);
+            transport_->receive(&discard[0]);
+        }
+        if (ownTransport_) {
+            delete transport_;
+        }
+        transport_ = NULL;
+    }
+
     // Terminate MPI environment.
     MPI_Finalize();
+
+    for (std::vector<AlpsPendingSend*>::size_type k = 0;
+         k < sendSlots_.size(); ++k) {
+        delete sendSlots_[k]->encoded;
+        delete sendSlots_[k];
+    }
+    sendSlots_.clear();
 }
 
 //#############################################################################
@@ -5665,6 +7185,7 @@ AlpsKnowledgeBrokerMPI::incSendCount(const char* how, int s)
     }
 
     sendCount_ += s;
+    totalSendCount_ += s;
 }
 
 //#############################################################################
@@ -5679,6 +7200,7 @@ AlpsKnowledgeBrokerMPI::decSendCount(const char* how, int s)
     }
 
     sendCount_ -= s;
+    totalSendCount_ -= s;
 }
 
 //#############################################################################
@@ -5693,6 +7215,7 @@ AlpsKnowledgeBrokerMPI::incRecvCount(const char* how, int s)
     }
 
     recvCount_ += s;
+    totalRecvCount_ += s;
 }
 
 //#############################################################################
@@ -5707,6 +7230,49 @@ AlpsKnowledgeBrokerMPI::decRecvCount(const char* how, int s)
     }
 
     recvCount_ -= s;
+    totalRecvCount_ -= s;
+}
+
+//#############################################################################
+
+bool
+AlpsKnowledgeBrokerMPI::testTermination()
+{
+    bool terminate = false;
+
+    if (termRequest_ != MPI_REQUEST_NULL) {
+        int done = 0;
+        MPI_Test(&termRequest_, &done, MPI_STATUS_IGNORE);
+        if (!done) {
+            return false;
+        }
+        ++numTermWaves_;
+
+        // All contributions to a wave precede its completion anywhere, so
+        // if nothing changed between two waves, nobody had work or received
+        // a message in between and no message was in transit. Every
+        // process sees the same values and decides alike.
+        if (termGlobal_[0] == 0 &&
+            termGlobal_[1] == termGlobal_[2] &&
+            termPrevious_[0] == 0 &&
+            termPrevious_[1] == termGlobal_[1] &&
+            termPrevious_[2] == termGlobal_[2]) {
+            terminate = true;
+        }
+        memcpy(termPrevious_, termGlobal_, sizeof(termGlobal_));
+    }
+
+    if (!terminate) {
+        bool hasWork = (workingSubTree_ != 0 ||
+                        subTreePool_->hasKnowledge());
+        termLocal_[0] = hasWork ? 1 : 0;
+        termLocal_[1] = totalSendCount_;
+        termLocal_[2] = totalRecvCount_;
+        MPI_Iallreduce(termLocal_, termGlobal_, 3, MPI_LONG_LONG_INT, MPI_SUM,
+                       MPI_COMM_WORLD, &termRequest_);
+    }
+
+    return terminate;
 }
 
 //#############################################################################
@@ -5732,7 +7298,12 @@ AlpsKnowledgeBrokerMPI::sendKnowledge(AlpsKnowledgeType type,
         sendRampUpNode(receiver, comm);
         break;
     case AlpsKnowledgeTypeSolution:
-        sendIncumbent();
+        if (incumbentWin_ != MPI_WIN_NULL) {
+            publishIncumbent();
+        }
+        else {
+            sendIncumbent();
+        }
         break;
     case AlpsKnowledgeTypeSubTree:
         break;
@@ -5809,76 +7380,189 @@ AlpsKnowledgeBrokerMPI::requestKnowledge(AlpsKnowledgeType type,
 
 //#############################################################################
 
-/** Set generated knowlege (related to model) to receiver. */
-// NOTE: comm is hubComm_ or MPI_COMM_WORLD.
+/** Forward the model knowledge received in buf. */
+// NOTE: modelGenID_, modelGenPos_ and modelGenHops_ are set by
+// receiveModelKnowledge.
 void
-AlpsKnowledgeBrokerMPI::forwardModelKnowledge()
+AlpsKnowledgeBrokerMPI::forwardModelKnowledge(char* buf)
 {
-    assert(modelGenPos_ > 0);
+    if (modelGenPos_ <= 0) {
+        // Seen before, its other copies reach the same processes.
+        return;
+    }
 
-    // Binary forewarding
-    int mySeq = rankToSequence(modelGenID_, globalRank_);
-    int leftSeq = leftSequence(mySeq, processNum_);
-    int rightSeq = rightSequence(mySeq, processNum_);
+    std::vector<int> targets;
+    modelKnowledgeTargets(modelGenID_, ++modelGenHops_, targets);
+    if (targets.empty()) {
+        return;
+    }
 
 #if 0
-    std::cout << "++++ forwardModelKnowledge: mySeq = " << mySeq
-              << ", leftSeq = " << leftSeq
-              << ", rightSeq = " << rightSeq
-              << ", modelGenID_ = " << modelGenID_
+    std::cout << "++++ forwardModelKnowledge: modelGenID_ = " << modelGenID_
+              << ", hops = " << modelGenHops_
               << ", globalRank_ = " << globalRank_
+              << ", targets = " << targets.size()
               << std::endl;
 #endif
 
-    if (leftSeq != -1) {
-        if (forwardRequestL_ != MPI_REQUEST_NULL) {
-            // Test if previous sending has completed.
-            int alreadySent = false;
-            MPI_Status sentStatus;
-            MPI_Test(&forwardRequestL_, &alreadySent, &sentStatus);
-            if (!alreadySent) { // Previous sending hasn't complete
-                std::cout << "++++ Previous left forwardModelKnowledge hasn't finished."
-                          << std::endl;
-                return;
-            }
-        }
+    // Update the hop count in place.
+    int position = 0;
+    MPI_Pack(&modelGenID_, 1, MPI_INT, buf, largeSize_, &position,
+             MPI_COMM_WORLD);
+    MPI_Pack(&modelGenHops_, 1, MPI_INT, buf, largeSize_, &position,
+             MPI_COMM_WORLD);
 
-        // Note: modelGenPos_ is set by recieveModelKnowledge
-        int leftRank = sequenceToRank(modelGenID_, leftSeq);
-        MPI_Isend(largeBuffer_, modelGenPos_, MPI_PACKED, leftRank,
-                  AlpsMsgModelGenSearch, MPI_COMM_WORLD, &forwardRequestL_);
-#if 0
-        std::cout << "++++ forwardModelKnowledge: leftRank = "
-                  << leftRank << std::endl;
-#endif
-        MPI_Status sentStatusL;
-        MPI_Wait(&forwardRequestL_, &sentStatusL);
+    for (size_t k = 0; k < targets.size(); ++k) {
+        queueMessage(targets[k], AlpsMsgModelGenSearch, buf, modelGenPos_);
         incSendCount("forwardModelKnowledge during search");
     }
+    chargeModelKnowledge(modelGenPos_ * static_cast<int>(targets.size()));
+}
 
-    if (rightSeq != -1) {
-        if (forwardRequestR_ != MPI_REQUEST_NULL) {
-            // Test if previous sending has completed.
-            int alreadySent = false;
-            MPI_Status sentStatus;
-            MPI_Test(&forwardRequestR_, &alreadySent, &sentStatus);
-            if (!alreadySent) { // Previous sending hasn't complete
-                std::cout << "++++ Previous right forwardModelKnowledge hasn't finished."
-                          << std::endl;
-                return;
+//#############################################################################
+
+/** The processes to pass model knowledge to. */
+void
+AlpsKnowledgeBrokerMPI::modelKnowledgeTargets(int origin,
+                                              int hops,
+                                              std::vector<int>& targets)
+{
+    int i;
+    targets.clear();
+
+    switch (knowledgeTopology_) {
+    case AlpsKnowledgeRing:
+    {
+        const int next = (globalRank_ + 1) % processNum_;
+        if (next != origin) {
+            targets.push_back(next);
+        }
+        break;
+    }
+    case AlpsKnowledgeHypercube:
+    {
+        // Binomial tree over the ranks relative to the origin: a process
+        // sends along the dimensions above its highest set bit.
+        const int rel = (globalRank_ - origin + processNum_) % processNum_;
+        int bit = 1;
+        while (bit <= rel) {
+            bit <<= 1;
+        }
+        for (; rel + bit < processNum_; bit <<= 1) {
+            targets.push_back((origin + rel + bit) % processNum_);
+        }
+        break;
+    }
+    case AlpsKnowledgeGossip:
+    {
+        int ttl = 0;
+        while ((1 << ttl) < processNum_) {
+            ++ttl;
+        }
+        if (hops >= ttl) {
+            break;
+        }
+        std::uniform_int_distribution<int> pick(0, processNum_ - 2);
+        for (i = 0; i < 2; ++i) {
+            int peer = pick(knowledgeRandom_);
+            if (peer >= globalRank_) {
+                ++peer;
+            }
+            if (peer != origin &&
+                std::find(targets.begin(), targets.end(), peer) ==
+                targets.end()) {
+                targets.push_back(peer);
             }
         }
-        int rightRank = sequenceToRank(modelGenID_, rightSeq);
-#if 0
-        std::cout << "++++ forwardModelKnowledge: rightRank = "
-                  << rightRank << std::endl;
-#endif
-        MPI_Isend(largeBuffer_, modelGenPos_, MPI_PACKED, rightRank,
-                  AlpsMsgModelGenSearch, MPI_COMM_WORLD, &forwardRequestR_);
-        MPI_Status sentStatusR;
-        MPI_Wait(&forwardRequestR_, &sentStatusR);
-        incSendCount("forwardModelKnowledge during search");
+        break;
+    }
+    case AlpsKnowledgeHubMediated:
+    {
+        // The origin hands the knowledge to its hub, which passes it on
+        // to the other hubs; each hub delivers it to its cluster.
+        const int originHub = hubRanks_[clusterIndexList_[origin]];
+        const int myHub = hubRanks_[clusterIndexList_[globalRank_]];
+        if (globalRank_ != myHub) {
+            if (globalRank_ == origin) {
+                targets.push_back(myHub);
+            }
+            break;
+        }
+        if (globalRank_ == originHub) {
+            for (i = 0; i < hubNum_; ++i) {
+                if (hubRanks_[i] != globalRank_) {
+                    targets.push_back(hubRanks_[i]);
+                }
+            }
+        }
+        for (i = 0; i < clusterSize_; ++i) {
+            if (clusterRanks_[i] != globalRank_ &&
+                clusterRanks_[i] != origin) {
+                targets.push_back(clusterRanks_[i]);
+            }
+        }
+        break;
+    }
+    default:
+    {
+        // Binary tree rooted at the origin.
+        int mySeq = rankToSequence(origin, globalRank_);
+        int leftSeq = leftSequence(mySeq, processNum_);
+        int rightSeq = rightSequence(mySeq, processNum_);
+        if (leftSeq != -1) {
+            targets.push_back(sequenceToRank(origin, leftSeq));
+        }
+        if (rightSeq != -1) {
+            targets.push_back(sequenceToRank(origin, rightSeq));
+        }
+        break;
+    }
+    }
+}
+
+//#############################################################################
+
+/** Check and remember the content hash of shared knowledge. */
+bool
+AlpsKnowledgeBrokerMPI::modelKnowledgeSeen(const AlpsEncoded* encoded)
+{
+    if (knowledgeDedupSize_ <= 0) {
+        return false;
+    }
+
+    const unsigned long long hash =
+        AlpsHashBytes(encoded->representation(), encoded->size());
+    if (knowledgeHashSet_.count(hash)) {
+        return true;
+    }
+
+    knowledgeHashes_.push_back(hash);
+    knowledgeHashSet_.insert(hash);
+    if (static_cast<int>(knowledgeHashes_.size()) > knowledgeDedupSize_) {
+        knowledgeHashSet_.erase(knowledgeHashes_.front());
+        knowledgeHashes_.pop_front();
+    }
+    return false;
+}
+
+//#############################################################################
+
+/** Count bytes of shared knowledge against the budget of the period. */
+bool
+AlpsKnowledgeBrokerMPI::chargeModelKnowledge(int bytes)
+{
+    if (knowledgeBudget_ <= 0) {
+        return true;
     }
+
+    const double now = AlpsGetTimeOfDay();
+    if (now - knowledgePeriodStart_ >= knowledgeBudgetPeriod_) {
+        knowledgePeriodStart_ = now;
+        knowledgeBytesSent_ = 0;
+    }
+    knowledgeBytesSent_ += bytes;
+
+    return knowledgeBytesSent_ < knowledgeBudget_;
 }
 
 //#############################################################################
@@ -5892,22 +7576,32 @@ AlpsKnowledgeBrokerMPI::sendModelKnowledge(MPI_Comm comm, int receiver)
 {
     int size = largeSize_;
     int position = 0;
+    int hops = 0;
 
     bool hasKnowledge = false;
 
     assert(largeBuffer2_);
 
-    // Pack original sender's global rank
+    // Leave the knowledge in the model once the budget is used up.
+    if (phase_ == AlpsPhaseSearch && !chargeModelKnowledge(0)) {
+        return;
+    }
+
+    const double packStart = profileClock();
+
+    // Pack original sender's global rank and the hop count
     position = 0;
     MPI_Pack(&globalRank_, 1, MPI_INT, largeBuffer2_, largeSize_,
              &position, comm);
+    MPI_Pack(&hops, 1, MPI_INT, largeBuffer2_, largeSize_, &position, comm);
 
     //std::cout << "----- 1. position = " << position << std::endl;
 
     // Retrieve and pack generated model knowledge
     AlpsEncoded *encoded = model_->packSharedKnowlege();
 
-    if (encoded) {
+    if (encoded &&
+        (phase_ != AlpsPhaseSearch || !modelKnowledgeSeen(encoded))) {
         hasKnowledge = true;
         // Pack into local buffer
         packEncoded(encoded, largeBuffer2_, size, position, comm);
@@ -5922,6 +7616,8 @@ AlpsKnowledgeBrokerMPI::sendModelKnowledge(MPI_Comm comm, int receiver)
     //std::cout << "----- 2. position = " << position
     //        << ", size = " << size << std::endl;
     delete encoded;
+    profilePack(phase_ == AlpsPhaseRampup ? AlpsMsgModelGenRampUp :
+                AlpsMsgModelGenSearch, packStart);
 
     if (phase_ == AlpsPhaseRampup) {
         assert(comm == clusterComm_ || comm == hubComm_);
@@ -5942,14 +7638,6 @@ AlpsKnowledgeBrokerMPI::sendModelKnowledge(MPI_Comm comm, int receiver)
     }
     else if ( hasKnowledge && (phase_ == AlpsPhaseSearch) ) {
         assert(comm == MPI_COMM_WORLD);
-#if 0
-        // Attach buffer
-        if (!attachBuffer_) {
-            int attachSize = 2 * (largeSize_  + MPI_BSEND_OVERHEAD );
-            attachBuffer_ =  new char [attachSize];
-            MPI_Buffer_attach(attachBuffer_, attachSize);
-        }
-#endif
 
 #if 0
         std::cout << "---- Process[" << globalRank_
@@ -5957,56 +7645,14 @@ AlpsKnowledgeBrokerMPI::sendModelKnowledge(MPI_Comm comm, int receiver)
                   << "position " << position << std::endl;
 #endif
 
-        // During search, binary sending
-        int mySeq = rankToSequence(globalRank_, globalRank_);
-        int leftSeq = leftSequence(mySeq, processNum_);
-        int rightSeq = rightSequence(mySeq, processNum_);
-
-        if (leftSeq != -1) {
-            if (modelKnowRequestL_ != MPI_REQUEST_NULL) {
-                // Test if previous sending has completed.
-                int alreadySent = false;
-                MPI_Status sentStatus;
-                MPI_Test(&modelKnowRequestL_, &alreadySent, &sentStatus);
-                if (!alreadySent) { // Previous sending hasn't complete
-                    return;
-                }
-            }
-            int leftRank = sequenceToRank(globalRank_, leftSeq);
-            // Buffered send
-            //MPI_Bsend(largeBuffer2_, position, MPI_PACKED, leftRank,
-            //      AlpsMsgModelGenSearch, comm);
-            //MPI_Send(largeBuffer2_, position, MPI_PACKED, leftRank,
-            //     AlpsMsgModelGenSearch, comm);
-            MPI_Isend(largeBuffer2_, position, MPI_PACKED, leftRank,
-                      AlpsMsgModelGenSearch, comm, &modelKnowRequestL_);
-            MPI_Status sentStatusL;
-            MPI_Wait(&forwardRequestL_, &sentStatusL);
-            incSendCount("sendModelKnowledge during search");
-        }
-
-        if (rightSeq != -1) {
-            if (modelKnowRequestR_ != MPI_REQUEST_NULL) {
-                // Test if previous sending has completed.
-                int alreadySent = false;
-                MPI_Status sentStatus;
-                MPI_Test(&modelKnowRequestR_, &alreadySent, &sentStatus);
-                if (!alreadySent) { // Previous sending hasn't complete
-                    return;
-                }
-            }
-            int rightRank = sequenceToRank(globalRank_, rightSeq);
-            // Buffered send
-            //MPI_Bsend(largeBuffer2_, position, MPI_PACKED, rightRank,
-            //      AlpsMsgModelGenSearch, comm);
-            //MPI_Send(largeBuffer2_, position, MPI_PACKED, rightRank,
-            //     AlpsMsgModelGenSearch, comm);
-            MPI_Isend(largeBuffer2_, position, MPI_PACKED, rightRank,
-                      AlpsMsgModelGenSearch, comm, &modelKnowRequestR_);
-            MPI_Status sentStatusR;
-            MPI_Wait(&forwardRequestR_, &sentStatusR);
+        std::vector<int> targets;
+        modelKnowledgeTargets(globalRank_, hops, targets);
+        for (size_t k = 0; k < targets.size(); ++k) {
+            queueMessage(targets[k], AlpsMsgModelGenSearch, largeBuffer2_,
+                         position);
             incSendCount("sendModelKnowledge during search");
         }
+        chargeModelKnowledge(position * static_cast<int>(targets.size()));
     }
 }
 
@@ -6015,7 +7661,7 @@ AlpsKnowledgeBrokerMPI::sendModelKnowledge(MPI_Comm comm, int receiver)
 /** Receive generated knowlege (related to model) from sender. */
 // NOTE: comm is hubComm_ or MPI_COMM_WORLD.
 void
-AlpsKnowledgeBrokerMPI::receiveModelKnowledge(MPI_Comm comm)
+AlpsKnowledgeBrokerMPI::receiveModelKnowledge(MPI_Comm comm, char* buf)
 {
     int position = 0;
     int count = 0;
@@ -6046,7 +7692,7 @@ AlpsKnowledgeBrokerMPI::receiveModelKnowledge(MPI_Comm comm)
         //  << ", count = " << count << std::endl;
     }
     else if (phase_ == AlpsPhaseSearch) {
-        localBuffer = largeBuffer_;
+        localBuffer = buf ? buf : largeBuffer_;
     }
     else {
         assert(0);
@@ -6057,6 +7703,8 @@ AlpsKnowledgeBrokerMPI::receiveModelKnowledge(MPI_Comm comm)
         position = 0;  // Start from position 0 in local buffer
         MPI_Unpack(localBuffer, largeSize_, &position, &modelGenID_, 1,
                    MPI_INT, comm);
+        MPI_Unpack(localBuffer, largeSize_, &position, &modelGenHops_, 1,
+                   MPI_INT, comm);
 
         //std::cout << "PROCESS[" << globalRank_ << "] : recive gen model"
         //  << ", count = " << count << ", from " << modelGenID_
@@ -6071,8 +7719,14 @@ AlpsKnowledgeBrokerMPI::receiveModelKnowledge(MPI_Comm comm)
         // Record actuall buffer size for broadcasting
         modelGenPos_ = position;
 
-        // Upack and store knowledge from larger buffer.
-        model_->unpackSharedKnowledge(*encodedModelGen);
+        if (phase_ == AlpsPhaseSearch && modelKnowledgeSeen(encodedModelGen)) {
+            // Already stored and forwarded.
+            modelGenPos_ = 0;
+        }
+        else {
+            // Upack and store knowledge from larger buffer.
+            model_->unpackSharedKnowledge(*encodedModelGen);
+        }
 
         delete encodedModelGen;
         encodedModelGen = 0;
@@ -6092,8 +7746,7 @@ AlpsKnowledgeBrokerMPI::sendErrorCodeToMaster(int errorCode)
     int size = model_->AlpsPar()->entry(AlpsParams::smallSize);
     int pos = 0;
     MPI_Pack(&errorCode, 1, MPI_INT, smallBuffer_, size, &pos, MPI_COMM_WORLD);
-    MPI_Send(smallBuffer_, pos, MPI_PACKED, masterRank_, AlpsMsgErrorCode,
-             MPI_COMM_WORLD);
+    postSend(masterRank_, AlpsMsgErrorCode, smallBuffer_, pos);
     incSendCount("sendErrorCodeToMaster");
 }
 
@@ -6145,12 +7798,18 @@ AlpsKnowledgeBrokerMPI::rootInitMaster(AlpsTreeNode* root)
             << globalRank_ << requiredNumNodes << CoinMessageEol;
     }
 
-    rampUpSubTree_ = dynamic_cast<AlpsSubTree*>
-        (const_cast<AlpsKnowledge *>(decoderObject(AlpsKnowledgeTypeSubTree)))
-        ->newSubTree();
-    rampUpSubTree_->setBroker(this);
-    rampUpSubTree_->setNodeSelection(rampUpNodeSelection_);
-    rampUpSubTree_->setNextIndex(1); // One more than root's index
+    if (rampUpSubTree_) {
+        // Left by the racing ramp-up, which processed the root.
+        root = NULL;
+    }
+    else {
+        rampUpSubTree_ = dynamic_cast<AlpsSubTree*>
+            (const_cast<AlpsKnowledge *>
+             (decoderObject(AlpsKnowledgeTypeSubTree)))->newSubTree();
+        rampUpSubTree_->setBroker(this);
+        rampUpSubTree_->setNodeSelection(rampUpNodeSelection_);
+        rampUpSubTree_->setNextIndex(1); // One more than root's index
+    }
 
     nodeProcessedNum_ += rampUpSubTree_->rampUp(hubNum_,
                                                 requiredNumNodes,
@@ -6705,7 +8364,12 @@ AlpsKnowledgeBrokerMPI::rootInitWorker()
             break;
         }
 
-        assert(rampUpSubTree_->getNumNodes() > 0);
+        if (rampUpSubTree_->getNumNodes() == 0) {
+            // The node was pruned by the incumbent.
+            delete rampUpSubTree_;
+            rampUpSubTree_ = NULL;
+            continue;
+        }
 
         rampUpSubTree_->calculateQuality();
 
@@ -6738,6 +8402,213 @@ AlpsKnowledgeBrokerMPI::rootInitWorker()
 
 //#############################################################################
 
+// Create the node selection rule of a search strategy.
+static AlpsSearchStrategy<AlpsTreeNode*>*
+newNodeSelection(int strategy)
+{
+    switch (strategy) {
+    case AlpsSearchTypeBestFirst:
+        return new AlpsNodeSelectionBest;
+    case AlpsSearchTypeBreadthFirst:
+        return new AlpsNodeSelectionBreadth;
+    case AlpsSearchTypeDepthFirst:
+        return new AlpsNodeSelectionDepth;
+    case AlpsSearchTypeBestEstimate:
+        return new AlpsNodeSelectionEstimate;
+    case AlpsSearchTypeHybrid:
+        return new AlpsNodeSelectionHybrid;
+    default:
+        throw CoinError("Unknown search strategy", "newNodeSelection",
+                        "AlpsKnowledgeBrokerMPI");
+    }
+}
+
+//#############################################################################
+
+void
+AlpsKnowledgeBrokerMPI::racingRampUp(AlpsTreeNode* root)
+{
+    int i = 0;
+    int numProcessed = 0;
+
+    MPI_Status status;
+
+    const int requiredNumNodes =
+        model_->AlpsPar()->entry(AlpsParams::racingNodeNum);
+    const int nodeLimit =
+        model_->AlpsPar()->entry(AlpsParams::racingNodeLimit);
+    const int userStrategy =
+        model_->AlpsPar()->entry(AlpsParams::searchStrategyRampUp);
+    const int numStrategies = AlpsSearchTypeHybrid + 1;
+
+    if (globalRank_ == masterRank_ && msgLevel_ > 0) {
+        messageHandler()->message(ALPS_STATIC_BALANCE_BEG, messages())
+            << "the Racing Ramp-up" << CoinMessageEol;
+    }
+
+    //------------------------------------------------------
+    // Each process races with its own seed, counted from the master which
+    // keeps the user's settings. The seed picks the ramp-up search strategy
+    // and is passed to the model to vary its parameters.
+    //------------------------------------------------------
+
+    int seed = (globalRank_ - masterRank_ + processNum_) % processNum_;
+    AlpsSearchStrategy<AlpsTreeNode*>* raceSelection =
+        newNodeSelection((userStrategy + seed) % numStrategies);
+    model_->setRacingSeed(seed);
+
+    rampUpSubTree_ = dynamic_cast<AlpsSubTree*>
+        (const_cast<AlpsKnowledge *>
+         (decoderObject(AlpsKnowledgeTypeSubTree)))->newSubTree();
+    rampUpSubTree_->setBroker(this);
+    rampUpSubTree_->setNodeSelection(raceSelection);
+
+    //------------------------------------------------------
+    // The master sends a copy of the root to everyone, then all race.
+    // A racer stops at the node or time limit of the race, or when the
+    // search runs out of time, so that no racer searches the whole tree
+    // while the others wait for the race to be decided.
+    //------------------------------------------------------
+
+    const double timeLimit =
+        CoinMin(model_->AlpsPar()->entry(AlpsParams::racingTimeLimit),
+                timer_.limit_ - timer_.getWallClockTime());
+
+    if (globalRank_ == masterRank_) {
+        AlpsEncoded* enc = encodeRampUpNode(root);
+        for (i = 0; i < processNum_; ++i) {
+            if (i != masterRank_) {
+                sendSizeEncoded(enc, i, AlpsMsgNode, MPI_COMM_WORLD);
+            }
+        }
+        delete enc;
+        rampUpSubTree_->setNextIndex(1); // One more than root's index
+        numProcessed = rampUpSubTree_->rampUp(0, requiredNumNodes,
+                                              treeDepth_, root,
+                                              nodeLimit, timeLimit);
+    }
+    else {
+        receiveRampUpNode(masterRank_, MPI_COMM_WORLD, &status);
+        numProcessed = rampUpSubTree_->rampUp(0, requiredNumNodes,
+                                              treeDepth_, NULL,
+                                              nodeLimit, timeLimit);
+    }
+
+    //------------------------------------------------------
+    // Decide the race. No solution is better than the best quality of a
+    // racer's open nodes or than its best solution, so the racer with the
+    // highest such bound proved the most. Ties go to the better solution,
+    // then to the lower rank.
+    //------------------------------------------------------
+
+    double mine[3];
+    mine[1] = ALPS_OBJ_MAX;
+    if (hasKnowledge(AlpsKnowledgeTypeSolution)) {
+        mine[1] = getBestKnowledge(AlpsKnowledgeTypeSolution).second;
+    }
+    mine[0] = std::min(rampUpSubTree_->nodePool()->getBestKnowledgeValue(),
+                       mine[1]);
+    mine[2] = numProcessed;
+
+    std::vector<double> races(3 * processNum_);
+    MPI_Allgather(mine, 3, MPI_DOUBLE, &races[0], 3, MPI_DOUBLE,
+                  MPI_COMM_WORLD);
+
+    int winner = 0;
+    int solOwner = 0;
+    for (i = 1; i < processNum_; ++i) {
+        if (races[3*i] > races[3*winner] ||
+            (races[3*i] == races[3*winner] &&
+             races[3*i+1] < races[3*winner+1])) {
+            winner = i;
+        }
+        if (races[3*i+1] < races[3*solOwner+1]) {
+            solOwner = i;
+        }
+    }
+
+    // The losers repeated work the winner's tree already covers, so only
+    // the winner's race nodes count as processed.
+    if (globalRank_ == winner) {
+        nodeProcessedNum_ += numProcessed;
+    }
+
+    //------------------------------------------------------
+    // Keep the best solution of all racers. Like any incumbent, it stays
+    // with the process that found it.
+    //------------------------------------------------------
+
+    if (races[3*solOwner+1] < incumbentValue_) {
+        incumbentValue_ = races[3*solOwner+1];
+        incumbentID_ = solOwner;
+        if (globalRank_ == solOwner && incumbentWin_ != MPI_WIN_NULL) {
+            publishIncumbent();
+        }
+    }
+
+    if (globalRank_ == masterRank_ && msgLevel_ > 0) {
+        messageHandler()->message(ALPS_RAMPUP_RACE, messages())
+            << winner << races[3*winner]
+            << static_cast<int>(races[3*winner+2])
+            << incumbentValue_ << CoinMessageEol;
+    }
+
+    //------------------------------------------------------
+    // Everyone continues the ramp-up with the winner's settings.
+    //------------------------------------------------------
+
+    seed = (winner - masterRank_ + processNum_) % processNum_;
+    model_->setRacingSeed(seed);
+    setRampUpNodeSelection(newNodeSelection((userStrategy + seed) %
+                                            numStrategies));
+    rampUpSubTree_->setNodeSelection(rampUpNodeSelection_);
+    delete raceSelection;
+
+    //------------------------------------------------------
+    // The winner's open nodes go to the master, which distributes them
+    // by root initialization. The other trees are dropped.
+    //------------------------------------------------------
+
+    if (winner == masterRank_) {
+        if (globalRank_ != masterRank_) {
+            delete rampUpSubTree_;
+            rampUpSubTree_ = NULL;
+        }
+    }
+    else if (globalRank_ == winner) {
+        while (rampUpSubTree_->nodePool()->hasKnowledge()) {
+            sendRampUpNode(masterRank_, MPI_COMM_WORLD);
+        }
+        sendFinishInit(masterRank_, MPI_COMM_WORLD);
+        // The open nodes were freed as they were sent.
+        rampUpSubTree_->nullRootActiveNode();
+        delete rampUpSubTree_;
+        rampUpSubTree_ = NULL;
+    }
+    else if (globalRank_ == masterRank_) {
+        delete rampUpSubTree_;
+        rampUpSubTree_ = dynamic_cast<AlpsSubTree*>
+            (const_cast<AlpsKnowledge *>
+             (decoderObject(AlpsKnowledgeTypeSubTree)))->newSubTree();
+        rampUpSubTree_->setBroker(this);
+        rampUpSubTree_->setNodeSelection(rampUpNodeSelection_);
+        do {
+            receiveRampUpNode(winner, MPI_COMM_WORLD, &status);
+        } while (status.MPI_TAG != AlpsMsgFinishInit);
+    }
+    else {
+        delete rampUpSubTree_;
+        rampUpSubTree_ = NULL;
+    }
+
+    if (globalRank_ == masterRank_ && msgLevel_ > 0) {
+        messageHandler()->message(ALPS_STATIC_BALANCE_END, messages())
+            << "the Racing Ramp-up" << CoinMessageEol;
+    }
+}
+
+//#############################################################################
+
 void
 AlpsKnowledgeBrokerMPI::spiralMaster(AlpsTreeNode *root)
 {
@@ -7008,7 +8879,7 @@ AlpsKnowledgeBrokerMPI::spiralHub()
                     if (i != clusterRank_) {
                         // Send a node to work receiver
                         receiver =
-                            cluster2GlobalRank(masterRank_, myHubRank_, i);
+                            clusterRanks_[i];
                         sendNodeModelGen(receiver, 0); // Just recv,not work
                         ++numSent;
                     }
@@ -7022,7 +8893,7 @@ AlpsKnowledgeBrokerMPI::spiralHub()
         char* dummyBuf = 0;
         for (i = 0; i < clusterSize_; ++i) {
             if (i != clusterRank_) {
-                receiver = cluster2GlobalRank(masterRank_, myHubRank_, i);
+                receiver = clusterRanks_[i];
                 MPI_Send(dummyBuf, 0, MPI_PACKED, receiver,
                          AlpsMsgFinishInitHub, MPI_COMM_WORLD);
             }
@@ -7071,7 +8942,7 @@ AlpsKnowledgeBrokerMPI::spiralWorker()
     int count = 0;
     bool inRampUp = true;
 
-    if (hubWork_ || (globalRank_ < clusterSize_)) {
+    if (hubWork_ || (myHubRank_ == masterRank_)) {
         // Hub won't send it node to me since it works.
         // If in master's cluster, then exit now.
         exitCount = 1;
@@ -30,7 +30,12 @@
 #include "AlpsConfig.h"
 
 #include <cmath>
+#include <deque>
 #include <iosfwd>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
 
 // #undef SEEK_SET
 // #undef SEEK_END
@@ -41,6 +46,7 @@
 #include "AlpsKnowledge.h"
 #include "AlpsKnowledgeBroker.h"
 #include "AlpsParams.h"
+#include "AlpsTransport.h"
 
 //#############################################################################
 
@@ -80,6 +86,9 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Communicator of the cluster to which the process belongs. */
     MPI_Comm clusterComm_;
 
+    /** Communicator of the processes on the same shared memory node. */
+    MPI_Comm nodeComm_;
+
     /** Communicator consists of all hubs. */
     MPI_Comm hubComm_;
 
@@ -98,12 +107,42 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** The global ranks of the hubs. */
     int* hubRanks_;
 
+    /** The global ranks of the processes in the cluster to which the
+        process belongs, indexed by their rank in clusterComm_. */
+    int* clusterRanks_;
+
+    /** The cluster (index in hubRanks_) of all processes. */
+    int* clusterIndexList_;
+
+    /** The rank in its clusterComm_ of all processes. */
+    int* clusterRankList_;
+
+    /** The rank in nodeComm_ of all processes, MPI_UNDEFINED for processes
+        on other nodes. */
+    int* nodeRankList_;
+
     /** The global rank of its hub for a worker. */
     int myHubRank_;
 
     /** The global rank of the master. */
     int masterRank_;
 
+    /** The number of consecutive hubs in a group led by the master or a
+        sub-master. Equal to hubNum_ without sub-masters. */
+    int hubGroupSize_;
+
+    /** Whether this hub is the sub-master of its group. */
+    bool subMaster_;
+
+    /** The global rank of the process a hub reports to: the sub-master of
+        its group, or the master. */
+    int parentRank_;
+
+    /** The global ranks of the hubs and sub-masters reporting to the master
+        or a sub-master; the process itself comes first. The hub status
+        arrays are indexed in this order. */
+    std::vector<int> childRanks_;
+
     /** The AlpsProcessType of this process. */
     AlpsProcessType processType_;
 
@@ -113,20 +152,73 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Whether hub should also work as a worker. */
     bool hubWork_;
 
-    /** Send subtree request. */
-    MPI_Request subTreeRequest_;
-
-    /** Send model knoledge request. */
-    MPI_Request solRequestL_;
-    MPI_Request solRequestR_;
-
-    /** Send model knoledge request. */
-    MPI_Request modelKnowRequestL_;
-    MPI_Request modelKnowRequestR_;
-
-    /** Forward model knoledge request. */
-    MPI_Request forwardRequestL_;
-    MPI_Request forwardRequestR_;
+    /** A send posted by postSend() or postEncodedSend(). */
+    struct AlpsPendingSend {
+        /** Copy of the message, kept until the send completes. */
+        std::vector<char> buffer;
+        /** Encoded subtree sent in place, or NULL. */
+        AlpsEncoded* encoded;
+        /** Piggybacked incumbent value and rank, then the type and size of
+            encoded, sent in front of encoded. */
+        char head[sizeof(double) + 3 * sizeof(int)];
+        /** Tag of the message, for the message profile. */
+        int tag;
+        /** When the send was posted, if messages are profiled. */
+        double postTime;
+    };
+
+    /** Transport of the messages posted and processed during search. */
+    AlpsTransport* transport_;
+
+    /** Whether transport_ is deleted with the broker. */
+    bool ownTransport_;
+
+    /** Sends in flight. The index of a slot is the handle of its send in
+        transport_. Slots and their buffers are reused once their send
+        completes. */
+    std::vector<AlpsPendingSend*> sendSlots_;
+
+    /** Indices of the free slots. */
+    std::vector<int> freeSendSlots_;
+
+    /** Scratch space for the completed sends. */
+    std::vector<int> doneSendSlots_;
+
+    /** Traffic of one message tag, see the profileMessages parameter. */
+    struct AlpsMsgProfile {
+        /** Number of messages posted. */
+        double sendCount;
+        /** Bytes in the messages posted. */
+        double sendBytes;
+        /** Number of messages processed. */
+        double recvCount;
+        /** Bytes in the messages processed. */
+        double recvBytes;
+        /** Time (sec) spent packing messages. */
+        double packTime;
+        /** Time (sec) spent unpacking and handling messages. */
+        double unpackTime;
+        /** Time (sec) blocked waiting for messages. */
+        double waitTime;
+        /** Time (sec) from posting a send until it was found complete. */
+        double flightTime;
+    };
+
+    /** Whether message traffic is profiled. */
+    bool profileMessages_;
+
+    /** Traffic of each tag, indexed by AlpsMessageTag. */
+    std::vector<AlpsMsgProfile> msgProfile_;
+
+    /** Shared memory window through which subtrees are passed to
+        processes on the same node. MPI_WIN_NULL if not used. */
+    MPI_Win subTreeWin_;
+
+    /** This process's segment of subTreeWin_. */
+    char* subTreeSegment_;
+
+    /** The size of subTreeSegment_ in bytes. */
+    int subTreeSegmentSize_;
     //@}
 
     /** @name Incumbent data
@@ -142,6 +234,11 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Indicate whether the incumbent value is updated between two
         checking point. */
     bool updateIncumbent_;
+
+    /** Window on the master holding the incumbent value and owner as an
+        MPI_DOUBLE_INT pair. MPI_WIN_NULL if the incumbent is forwarded
+        with messages instead. */
+    MPI_Win incumbentWin_;
     //@}
 
     /** @name Workload balancing
@@ -233,11 +330,115 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     int systemRecvCount_;
     //@}
 
-    /** @name Node index
-     *
+    /** @name Decentralized termination detection
+     *  Every process repeatedly joins a nonblocking reduction (a wave) of
+     *  whether it has work and of its message totals. The search is over
+     *  when two consecutive waves see no work, equal sent and received
+     *  totals, and the same totals (four-counter method).
      */
     //@{
-    int masterIndexBatch_;
+    /** The number of messages sent by the process since the start. */
+    long long totalSendCount_;
+
+    /** The number of messages received by the process since the start. */
+    long long totalRecvCount_;
+
+    /** Reduction of the current wave. */
+    MPI_Request termRequest_;
+
+    /** Contribution of the process to the current wave: has work, sent
+        and received totals. */
+    long long termLocal_[3];
+
+    /** Reduced values of the current wave. */
+    long long termGlobal_[3];
+
+    /** Reduced values of the previous wave. */
+    long long termPrevious_[3];
+
+    /** The number of completed waves. */
+    int numTermWaves_;
+    //@}
+
+    /** @name Message coalescing
+     *  Small messages queued during the search are collected per
+     *  destination and sent as one AlpsMsgEnvelope. An envelope is a
+     *  sequence of {tag, size} headers, each followed by size bytes.
+     */
+    //@{
+    /** Pending envelope for each destination in MPI_COMM_WORLD. */
+    std::map<int, std::vector<char> > envelopes_;
+    //@}
+
+    /** @name Work stealing
+     *  With AlpsWorkStealing an idle worker sends AlpsMsgStealRequest to a
+     *  random worker or working hub, which answers with donateWork(). At
+     *  most one request per thief is outstanding.
+     */
+    //@{
+    /** Whether a steal request is waiting for its reply. */
+    bool stealPending_;
+
+    /** Seconds to wait after an empty steal reply. Doubles with each empty
+        reply, up to a bound, and is reset when work arrives. */
+    double stealDelay_;
+
+    /** Time of day before which no new steal request is sent. */
+    double stealNextTime_;
+
+    /** Global ranks of the other workers, and of the hubs if they process
+        nodes. */
+    std::vector<int> stealVictims_;
+
+    /** Generator used to pick victims. */
+    std::minstd_rand stealRandom_;
+    //@}
+
+    /** @name Self-tuning of load balancing
+     *  With selfTuneBalance each process adjusts the thresholds and the
+     *  balance period below once per tuning epoch (ten balance periods)
+     *  from what it measured during the epoch. They start from the
+     *  parameter values.
+     */
+    //@{
+    /** Relative quality gap above which a process donates. */
+    double donorThreshold_;
+
+    /** Relative quality gap above which a process receives. */
+    double receiverThreshold_;
+
+    /** Work quantity below which a worker asks for work. */
+    double needWorkThreshold_;
+
+    /** Quality gap above which a worker changes its working subtree. */
+    double changeWorkThreshold_;
+
+    /** Factor applied to masterBalancePeriod_ and hubReportPeriod_. */
+    double balancePeriodScale_;
+
+    /** Wall clock time when the epoch started, negative before the first. */
+    double tuneStartTime_;
+
+    /** Idle time of a worker when the epoch started. */
+    double tuneIdleTime_;
+
+    /** Statistics when the epoch started. */
+    AlpsPsStats tunePsStats_;
+
+    /** Messages processed in the epoch. */
+    int tuneMsgCount_;
+
+    /** Number of balance rounds in the epoch. */
+    int tuneRounds_;
+
+    /** Sum over the rounds of the fraction of workers short of work. */
+    double tuneStarved_;
+
+    /** Requests for work answered with a subtree in the epoch. */
+    int tuneWorkRecv_;
+
+    /** Requests for work answered with nothing in the epoch. */
+    int tuneWorkEmpty_;
     //@}
 
     /** @name Parallel statistics
@@ -310,6 +511,40 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Size of the shared knowledge. */
     int modelGenPos_;
 
+    /** The number of times the shared knowledge in hand has been
+        forwarded. */
+    int modelGenHops_;
+
+    /** Topology along which model knowledge is shared, see
+        AlpsKnowledgeTopology. */
+    int knowledgeTopology_;
+
+    /** Bytes of model knowledge a process may send per period, 0 if
+        unlimited. */
+    int knowledgeBudget_;
+
+    /** Length (sec) of a budget period. */
+    double knowledgeBudgetPeriod_;
+
+    /** Bytes of model knowledge sent in the current period. */
+    long knowledgeBytesSent_;
+
+    /** Start time of the current budget period. */
+    double knowledgePeriodStart_;
+
+    /** The number of content hashes remembered, 0 if duplicates are
+        not suppressed. */
+    int knowledgeDedupSize_;
+
+    /** Content hashes of recently shared model knowledge, oldest first. */
+    std::deque<unsigned long long> knowledgeHashes_;
+
+    /** The same hashes, for lookup. */
+    std::set<unsigned long long> knowledgeHashSet_;
+
+    /** Generator used to pick gossip peers. */
+    std::minstd_rand knowledgeRandom_;
+
     /** A subtree used in during up. */
     AlpsSubTree* rampUpSubTree_;
 
@@ -319,6 +554,11 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Temporily halt search */
     int haltSearch_;
 
+    /** The model was received but setupSelf has not been called yet. Workers
+        that take no part in ramp-up set up the model while the master
+        ramps up. */
+    bool deferSetupSelf_;
+
  protected:
 
     /** Initialize member data. */
@@ -354,16 +594,74 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
                                    int & depth,
                                    bool & betterSolution);
 
-    /** Processing messages. */
-    void processMessages(char *&buffer,
-                         MPI_Status &status,
-                         MPI_Request &request);
+    /** Receive and process one message from MPI_COMM_WORLD if one is
+        waiting. The receive is sized by probing. Every such message
+        starts with the incumbent of its sender, which is adopted if it is
+        better. Return false if there was no message. */
+    bool processMessages(MPI_Status &status);
+
+    /** Process one message, which may have come in an envelope. */
+    void processMessage(char *&buffer, MPI_Status &status);
+
+    /** Process each message of a received envelope. */
+    void processEnvelope(char *&buffer, MPI_Status &status);
+
+    /** Send a small packed message to receiver in MPI_COMM_WORLD. During
+        the search it is batched with other messages to the same receiver
+        until flushMessages() if coalescing is enabled. */
+    void queueMessage(int receiver, int tag, const char* buf, int size);
+
+    /** Send all pending envelopes. */
+    void flushMessages();
+
+    /** Send a copy of size bytes of buf to receiver without blocking. The
+        copy is kept until the send completes. */
+    void postSend(int receiver, int tag, const char* buf, int size);
+
+    /** Send an encoded subtree to receiver without blocking. The broker
+        takes ownership of enc and frees it once the send completes. */
+    void postEncodedSend(int receiver, int tag, AlpsEncoded* enc);
+
+    /** Return a free send slot, adding one if all are in use. */
+    int acquireSendSlot();
+
+    /** Free the slots of the sends that have completed. Never blocks. */
+    void progressSends();
+
+    /** Throw if the rank and size of transport are not those of this
+        process in MPI_COMM_WORLD. */
+    void checkTransport(const AlpsTransport* transport) const;
+
+    /** @name Message profile functions
+        They do nothing unless messages are profiled.
+     */
+    //@{
+    /** The time to pass to the functions below as start. */
+    double profileClock() const;
+    /** Record a message with tag posted. */
+    void profileSend(int tag, int bytes);
+    /** Record a message with tag processed since start. */
+    void profileRecv(int tag, int bytes, double start);
+    /** Record packing a message with tag since start. */
+    void profilePack(int tag, double start);
+    /** Record waiting for a message with tag since start. */
+    void profileWait(int tag, double start);
+    /** Write a message profile as a table, one row per tag used. */
+    void writeMsgProfile(std::ostream& os,
+                         const std::vector<AlpsMsgProfile>& profile) const;
+    //@}
 
     /** Static load balancing: Root Initialization */
     void rootInitMaster(AlpsTreeNode* root);
     void rootInitHub();
     void rootInitWorker();
 
+    /** Static load balancing: racing ramp-up. Every process explores a
+        copy of the root with its own seed, within the node and time limits
+        of the race; the winner's open nodes are left in the master's
+        rampUpSubTree_ for rootInitMaster(). */
+    void racingRampUp(AlpsTreeNode* root);
+
     /** Static load balancing: spiral */
     void spiralMaster(AlpsTreeNode* root);
     void spiralHub();
@@ -390,13 +688,17 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     virtual int getNumNodeLeftSystem()
     { return static_cast<int>(systemWorkQuantity_); }
 
-    /** A worker donate its workload to the specified worker. */
-    void donateWork(char*& buf,
+    /** A worker donate its workload to the specified worker. Return true
+        if a subtree was sent. */
+    bool donateWork(char*& buf,
                     int tag,
                     MPI_Status* status,
                     int recvID = -1,
                     double recvWL = 0.0);
 
+    /** An idle worker asks a random worker for a subtree. */
+    void stealWork();
+
     /** Hub allocates the donated workload to its workers. */
     void hubAllocateDonation(char*& buf, MPI_Status* status);
 
@@ -424,9 +726,17 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     // NOTE: comm is hubComm or MPI_COMM_WORLD.
     void masterUpdateSysStatus(char*& buf, MPI_Status* status, MPI_Comm comm);
 
-    /** The master re-calculate the system status. */
+    /** The master re-calculate the system status. A sub-master
+        re-calculates the status of its group. */
     void refreshSysStatus();
 
+    /** The position in childRanks_ of the child covering the given hub. */
+    int hubChildIndex(int hubIndex) const;
+
+    /** The master or sub-master that asked the donor to send work to this
+        hub. */
+    int donationBalancer(int donor) const;
+
     /** A hub adds its status to the cluster's status. */
     void refreshClusterStatus();
 
@@ -437,22 +747,6 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
 
     //------------------------------------------------------
 
-    /** @name Node index functions  // msg counts is modified inside
-     *
-     */
-    //@{
-    /** A worker ask for node index from master. */
-    void workerAskIndices();
-
-    /** A worker receive node index from master. */
-    void workerRecvIndices(char *&bufLarge);
-
-    /** Master send a batch of node indices to the receiving worker. */
-    void masterSendIndices(char *&bufLarge);
-    //@}
-
-    //------------------------------------------------------
-
     /** @name Other message passing member functions
      *
      */
@@ -460,6 +754,12 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Broadcast the model from source to other processes. */
     void broadcastModel(const int id, const int source);
 
+    /** Broadcast a buffer from root in chunks of given size along a binary
+        tree. A process forwards a chunk to its children as soon as it has
+        received it, so transfers on different levels overlap. */
+    void pipelineBroadcast(char* buf, int size, int chunkSize, int root,
+                           MPI_Comm comm);
+
     /** Sent the incumbent value and rank to its two child if eixt */
     void sendIncumbent();
 
@@ -467,12 +767,35 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
         having the incumbent in AlpsDataPool. */
     bool unpackSetIncumbent(char*& buf, MPI_Status* status);
 
+    /** Create the incumbent window if enabled. Collective. */
+    void createIncumbentWindow();
+
+    /** Free the incumbent window. Collective. */
+    void freeIncumbentWindow();
+
+    /** Merge the incumbent value and rank of this process into the
+        incumbent window with MPI_MINLOC. */
+    void publishIncumbent();
+
+    /** Read the incumbent window and adopt its incumbent if it is better
+        than the one this process knows. */
+    void readIncumbent();
+
+    /** Write the incumbent value and the rank of the process having it,
+        which go in front of every message sent through transport_. */
+    void packPiggyback(char* buf) const;
+
+    /** Adopt the incumbent written by packPiggyback() in front of a
+        received message if it is better than the one this process
+        knows. */
+    void unpackPiggyback(const char* buf);
+
     /** Send the best solution from the process having it to destination. */
     void collectBestSolution(int destination);
 
-    /** Inform master that a proc has received workload during a load
-        balance initialized by master. */
-    void tellMasterRecv();
+    /** Inform master (or a sub-master) that a proc has received workload
+        during a load balance initialized by it. */
+    void tellMasterRecv(int balancer);
 
     /** Inform hub that a proc has received workload during a load
         balance initialized by a hub. */
@@ -495,14 +818,14 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
                                MPI_Comm comm,
                                int size = -1);
 
-    /** Receive the size of buffer, allocate memory for buffer, then
-        receive the message and put it in buffer. */
+    /** Receive the size of an encoded object, allocate its representation,
+        then receive the message directly into it. Return NULL if
+        AlpsMsgFinishInit is received instead. */
     // NOTE: comm is hubComm_ or clusterComm_
-    void receiveSizeBuf(char*& buf,
-                        int sender,
-                        int tag,
-                        MPI_Comm comm,
-                        MPI_Status* status);
+    AlpsEncoded* receiveSizeEncoded(int sender,
+                                    int tag,
+                                    MPI_Comm comm,
+                                    MPI_Status* status);
 
     /** First receive the size and the contend of a node, then construct
         a subtree with this received node. */
@@ -515,14 +838,17 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
         the subtree pool.*/
     void receiveSubTree(char*& buf, int sender, MPI_Status* status);
 
-    /** Send the size and content of a buffer to the target process. */
+    /** Make each node donated by sendFrontier() the root of a subtree and
+        add it into the subtree pool. */
+    void unpackFrontier(AlpsEncoded& encoded);
+
+    /** Send the size and content of an encoded object to the target
+        process. The content is sent without packing it first. */
     // NOTE: comm is hubComm_ or clusterComm_.
-    void sendSizeBuf(char*& buf,
-                     int size,
-                     int position,
-                     const int target,
-                     const int tag,
-                     MPI_Comm comm);
+    void sendSizeEncoded(AlpsEncoded* enc,
+                         const int target,
+                         const int tag,
+                         MPI_Comm comm);
 
     /** Send the size and the content of the best node of a given subtree
         to the target process. */
@@ -536,6 +862,27 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Send a given subtree to the target process. */
     bool sendSubTree(const int target, AlpsSubTree*& st, int tag);
 
+    /** Send open leaf nodes of a given subtree to the target process, see
+        AlpsSubTree::splitFrontier(). Return false if there were none. */
+    bool sendFrontier(const int target, AlpsSubTree* st, bool whole,
+                      int tag);
+
+    /** Create the shared subtree window if enabled. Collective over
+        nodeComm_, called once largeSize_ is known. */
+    void createSubTreeWindow();
+
+    /** Free the shared subtree window. Collective over nodeComm_. */
+    void freeSubTreeWindow();
+
+    /** Place an encoded subtree in this process's shared segment and tell
+        receiver with a message of the given tag. Return false if the
+        receiver is on another node or the segment is still in use. */
+    bool sendSharedSubTree(int receiver, AlpsEncoded* enc, int tag);
+
+    /** Take an encoded subtree out of the shared segment of sender, as
+        announced in buf, and release the segment. */
+    AlpsEncoded* receiveSharedSubTree(int sender, char* buf);
+
     /** Send finish initialization signal to the target process. */
     // NOTE: comm is hubComm_ or clusterComm_.
     void sendFinishInit(const int target, MPI_Comm comm);
@@ -545,7 +892,21 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     void deleteSubTrees();
 
 
-    void forwardModelKnowledge();
+    /** Forward the model knowledge received in buf to the next processes
+        of the sharing topology. */
+    void forwardModelKnowledge(char* buf);
+
+    /** The processes this process passes model knowledge generated by
+        origin to, after it has been forwarded hops times. */
+    void modelKnowledgeTargets(int origin, int hops, std::vector<int>& targets);
+
+    /** Return true if the knowledge was shared recently, otherwise
+        remember it. */
+    bool modelKnowledgeSeen(const AlpsEncoded* encoded);
+
+    /** Count bytes of model knowledge against the budget. Return false if
+        the budget of the current period is used up. */
+    bool chargeModelKnowledge(int bytes);
 
     /** Set generated knowlege (related to model) to receiver. */
     // NOTE: comm is hubComm_ or MPI_COMM_WORLD.
@@ -553,7 +914,8 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
 
     /** Receive generated knowlege (related to model) from sender. */
     // NOTE: comm is hubComm_ or MPI_COMM_WORLD.
-    void receiveModelKnowledge(MPI_Comm comm);
+    // NOTE: During search, buf holds the message (largeBuffer_ if NULL).
+    void receiveModelKnowledge(MPI_Comm comm, char* buf = NULL);
 
     /** @name Change message counts functions
      */
@@ -568,6 +930,11 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     void decRecvCount(const char* how, int s = 1);
     //@}
 
+    /** Test the current termination wave and start the next one once it
+        has completed. Never blocks. Return true when the search has
+        terminated; all processes return true in the same wave. */
+    bool testTermination();
+
     /** Master tell hubs to terminate due to reaching limits or other reason.*/
     void masterForceHubTerm();
 
@@ -577,6 +944,12 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Change subtree to be explored if it is too worse. */
     void changeWorkingSubTree(double & changeWorkThreshold);
 
+    /** Called once per balance round by every process. With
+        selfTuneBalance, adjust the load balancing thresholds and period
+        at the end of each epoch and log the changes. <code>idleTime</code>
+        is the time the worker has been idle so far. */
+    void tuneBalance(double idleTime);
+
     /** Send error code to master. */
     void sendErrorCodeToMaster(int errorCode);
 
@@ -624,6 +997,16 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerMPI : public AlpsKnowledgeBroker {
     /** Query the type (master, hub, or worker) of the process. */
     virtual AlpsProcessType getProcType() const { return processType_; }
 
+    /** Post and process the messages of the search through the given
+        transport instead of MPI_COMM_WORLD. The broker does not take
+        ownership. Only point-to-point messages go through the transport:
+        MPI_Init, ramp-up, termination checks, collectives and the RMA
+        windows still use MPI directly, so the search must run under MPI
+        and the rank and size of the transport must be those in
+        MPI_COMM_WORLD. This is checked here if the search is already
+        initialized, otherwise in initializeSearch(). */
+    void setTransport(AlpsTransport* transport);
+
     /** This function
      * <ul>
      *  <li> initializes the message environment;
@@ -181,6 +181,37 @@ AlpsKnowledgeBrokerSerial::initializeSearch(int argc,
     timer_.setClockType(clockType);
     subTreeTimer_.setClockType(clockType);
     tempTimer_.setClockType(clockType);
+
+    //------------------------------------------------------
+    // Open checkpoint log if required.
+    //------------------------------------------------------
+
+    std::string checkpointFile =
+        model_->AlpsPar()->entry(AlpsParams::checkpointFile);
+    if (checkpointFile != "NONE") {
+        setupCheckpoint(checkpointFile,
+                        model_->AlpsPar()->entry(AlpsParams::checkpointRestart));
+    }
+
+    //------------------------------------------------------
+    // Open solution stream if required.
+    //------------------------------------------------------
+
+    std::string solutionStreamFile =
+        model_->AlpsPar()->entry(AlpsParams::solutionStreamFile);
+    if (solutionStreamFile != "NONE") {
+        setupSolutionStream(solutionStreamFile);
+    }
+
+    //------------------------------------------------------
+    // Open search tree event log if required.
+    //------------------------------------------------------
+
+    std::string eventLogFile =
+        model_->AlpsPar()->entry(AlpsParams::eventLogFile);
+    if (eventLogFile != "NONE") {
+        setupEventLog(eventLogFile);
+    }
 }
 
 //#############################################################################
@@ -227,14 +258,34 @@ AlpsKnowledgeBrokerSerial::rootSearch(AlpsTreeNode* root)
     const int nodeLimit = model_->AlpsPar()->entry(AlpsParams::nodeLimit);
 
     timer_.limit_ = model_->AlpsPar()->entry(AlpsParams::timeLimit);
-    status = workingSubTree_->exploreSubTree(root,
-                                             nodeLimit,
-                                             timer_.limit_,
-                                             nodeProcessedNum_,
-                                             nodeBranchedNum_,
-                                             nodeDiscardedNum_,
-                                             nodePartialNum_,
-                                             treeDepth_);
+
+    const bool restart =
+        model_->AlpsPar()->entry(AlpsParams::checkpointRestart);
+
+    if (restart && restoreCheckpoint() > 0) {
+        // Continue from the checkpointed subtrees instead of the root.
+        delete root;
+        root = NULL;
+        delete workingSubTree_;
+        workingSubTree_ = NULL;
+        status = exploreRestoredSubTrees(nodeLimit);
+    }
+    else {
+        status = workingSubTree_->exploreSubTree(root,
+                                                 nodeLimit,
+                                                 timer_.limit_,
+                                                 nodeProcessedNum_,
+                                                 nodeBranchedNum_,
+                                                 nodeDiscardedNum_,
+                                                 nodePartialNum_,
+                                                 treeDepth_);
+    }
+
+    if (checkpoint_ && (exitStatus_ == AlpsExitStatusNodeLimit ||
+                        exitStatus_ == AlpsExitStatusTimeLimit)) {
+        // Keep the unexplored part of the tree for a restart.
+        checkpoint();
+    }
 
     updateNumNodesLeft();
 
@@ -250,6 +301,65 @@ AlpsKnowledgeBrokerSerial::rootSearch(AlpsTreeNode* root)
 
 //#############################################################################
 
+AlpsReturnStatus
+AlpsKnowledgeBrokerSerial::exploreRestoredSubTrees(int nodeLimit)
+{
+    AlpsReturnStatus status = AlpsReturnStatusOk;
+    AlpsExitStatus exploreStatus = AlpsExitStatusInfeasible;
+
+    while (subTreePool_->hasKnowledge()) {
+        workingSubTree_ = dynamic_cast<AlpsSubTree*>
+            (subTreePool_->getKnowledge().first);
+        subTreePool_->popKnowledge();
+
+        int numNodesProcessed = 0;
+        int numNodesBranched = 0;
+        int numNodesDiscarded = 0;
+        int numNodesPartial = 0;
+        bool betterSolution = false;
+
+        status = workingSubTree_->exploreUnitWork(
+            false,
+            nodeLimit - nodeProcessedNum_,
+            timer_.limit_ - timer_.getTime(),
+            exploreStatus,
+            numNodesProcessed,
+            numNodesBranched,
+            numNodesDiscarded,
+            numNodesPartial,
+            treeDepth_,
+            betterSolution);
+
+        nodeProcessedNum_ += numNodesProcessed;
+        nodeBranchedNum_ += numNodesBranched;
+        nodeDiscardedNum_ += numNodesDiscarded;
+        nodePartialNum_ += numNodesPartial;
+
+        if (exploreStatus == AlpsExitStatusNodeLimit ||
+            exploreStatus == AlpsExitStatusTimeLimit) {
+            break;
+        }
+
+        delete workingSubTree_;
+        workingSubTree_ = NULL;
+    }
+
+    if (exploreStatus == AlpsExitStatusNodeLimit ||
+        exploreStatus == AlpsExitStatusTimeLimit) {
+        setExitStatus(exploreStatus);
+    }
+    else if (hasKnowledge(AlpsKnowledgeTypeSolution)) {
+        setExitStatus(AlpsExitStatusOptimal);
+    }
+    else {
+        setExitStatus(AlpsExitStatusInfeasible);
+    }
+
+    return status;
+}
+
+//#############################################################################
+
 void
 AlpsKnowledgeBrokerSerial::searchLog()
 {
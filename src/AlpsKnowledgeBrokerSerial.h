@@ -152,5 +152,9 @@ class ALPSLIB_EXPORT AlpsKnowledgeBrokerSerial : public AlpsKnowledgeBroker {
     /** Search for best solution. */
     virtual void rootSearch(AlpsTreeNode* root);
 
+    /** Explore the subtrees restored from the checkpoint log until they
+        are exhausted or the node or time limit is reached. */
+    AlpsReturnStatus exploreRestoredSubTrees(int nodeLimit);
+
 };
 #endif
@@ -0,0 +1,101 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#include <cstdio>
+
+#if defined(_WIN32) || defined(_MSC_VER)
+#  define ALPS_NO_MMAP 1
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include "AlpsMappedFile.h"
+
+//#############################################################################
+
+AlpsMappedFile::AlpsMappedFile(const std::string& fileName)
+  :
+  data_(NULL),
+  length_(0),
+  mapped_(false)
+{
+#ifndef ALPS_NO_MMAP
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      data_ = static_cast<char*>(addr);
+      length_ = static_cast<long>(st.st_size);
+      mapped_ = true;
+    }
+  }
+  close(fd);
+#endif
+
+  if (!mapped_) {
+    // No mmap available, read the whole file instead.
+    FILE* fp = fopen(fileName.c_str(), "rb");
+    if (fp == NULL) {
+      return;
+    }
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (len > 0) {
+      data_ = new char [len];
+      length_ = static_cast<long>(fread(data_, 1, len, fp));
+    }
+    fclose(fp);
+  }
+}
+
+//#############################################################################
+
+AlpsMappedFile::~AlpsMappedFile()
+{
+  if (data_ == NULL) {
+    return;
+  }
+#ifndef ALPS_NO_MMAP
+  if (mapped_) {
+    munmap(data_, length_);
+    data_ = NULL;
+    return;
+  }
+#endif
+  delete [] data_;
+  data_ = NULL;
+}
+
+//#############################################################################
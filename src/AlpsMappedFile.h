@@ -0,0 +1,67 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+#ifndef AlpsMappedFile_h_
+#define AlpsMappedFile_h_
+
+#include "AlpsConfig.h"
+
+#include <string>
+
+//#############################################################################
+
+/** A read-only view of a whole file. The file is memory mapped where mmap
+    is available and read into memory otherwise. A missing or empty file
+    gives an empty view. */
+class ALPSLIB_EXPORT AlpsMappedFile {
+
+ private:
+
+  /** Start of the file contents. */
+  char* data_;
+  /** Length of the file in bytes. */
+  long length_;
+  /** Whether data_ is a mapping or a heap copy. */
+  bool mapped_;
+
+  AlpsMappedFile(const AlpsMappedFile&);
+  AlpsMappedFile& operator=(const AlpsMappedFile&);
+
+ public:
+  /** Map the given file. */
+  AlpsMappedFile(const std::string& fileName);
+  /** Unmap the file. */
+  ~AlpsMappedFile();
+
+  /** Get the file contents. */
+  const char* data() const { return data_; }
+  /** Get the length of the file. */
+  long length() const { return length_; }
+  /** Query whether the file is memory mapped. */
+  bool isMapped() const { return mapped_; }
+};
+
+#endif
@@ -41,6 +41,7 @@ typedef struct {
 
 static Alps_message us_english[] =
 {
+    {ALPS_CHECKPOINT_NO_RESTART, 5, 1, "Checkpoint restart is only supported in serial; starting new checkpoint logs %s.<rank>"},
     {ALPS_DONATE_AFTER, 11, 3, "Worker[%d] after donation %g nodes, %d subtrees"},
     {ALPS_DONATE_BEFORE, 14, 3, "Worker[%d] before donation %g nodes, %d subtrees"},
     {ALPS_DONATE_FAIL, 16, 3, "Worker[%d] fail to donate a subtree to %d, tag %d"},
@@ -57,6 +58,8 @@ static Alps_message us_english[] =
     {ALPS_LOADBAL_MASTER, 70, 3, "Master[%d] balanced the workloads of the hubs %d times"},
     {ALPS_LOADBAL_MASTER_NO, 72, 1, "Master[%d] balanced workload but do nothing since work load is %g"},
     {ALPS_LOADBAL_MASTER_PERIOD, 76, 1, "Master[%d] initially balances the hubs every %.4f seconds"},
+    {ALPS_LOADBAL_TUNE_HUB, 77, 1, "Hub[%d] tuned balancing: period %.4f, donor %g, receiver %g (short of work %.2f, msgs per worker %.2f)"},
+    {ALPS_LOADBAL_TUNE_WORKER, 78, 1, "Worker[%d] tuned balancing: need work %g, change work %g (idle %.2f, got work %d, got nothing %d)"},
     {ALPS_LOADBAL_WORKER_ASK, 80, 3, "Worker[%d] asks its hub (%d) for work"},
     {ALPS_LOADREPORT_MASTER, 90, 1, "Node %d: left %g, msg(s %d, r %d), inter(%d, %.5f), npt %.5f, unit %d, sol %g, %.0f sec."},
     {ALPS_LOADREPORT_MASTER_F, 92, 1, "Node %d: left(%g / %g), msg(s %d, r %d), inter %d, sol %g, %.0f sec."},
@@ -80,6 +83,7 @@ static Alps_message us_english[] =
     {ALPS_RAMPUP_MASTER_NODES_AUTO, 145, 1, "Master[%d] required %d nodes during rampup. Node processing time %g"},
     {ALPS_RAMPUP_MASTER_SOL, 146, 2, "Master[%d] found a better solution %g during rampup"},
     {ALPS_RAMPUP_MASTER_START, 148, 1, "Master[%d] is creating nodes (%d) for its hubs during rampup"},
+    {ALPS_RAMPUP_RACE, 149, 1, "Process[%d] won the racing rampup with bound %g and %d nodes; best solution %g"},
     {ALPS_RAMPUP_WORKER_RECV, 150, 3, "Worker[%d] received all subtrees (nodes) sent by its hub(%d)"},
     {ALPS_RAMPUP_WORKER_SOL, 153, 2, "Worker[%d] found a better solution %g during rampup"},
     {ALPS_SEARCH_WORKER_START, 155, 3, "Worker[%d] is searching solutions ..." },
@@ -87,6 +91,7 @@ static Alps_message us_english[] =
     {ALPS_SOLUTION_SEARCH, 162, 3, "Worker[%d] found a better solution %g during search"},
     {ALPS_STATIC_BALANCE_BEG, 165, 1, "Starting %s"},
     {ALPS_STATIC_BALANCE_END, 166, 1, "Completed %s"},
+    {ALPS_SUBMASTER_DECENTRAL_TERM, 168, 1, "Sub-masters require decentralized termination; setting decentralTermination to true"},
     {ALPS_TERM_FORCE_NODE, 170, 1, "Master asked other processes to stop searching due to reaching node limt %d"},
     {ALPS_TERM_FORCE_SOL, 174, 1, "Master asked other processes to stop searching due to reaching solution limt %d"},
     {ALPS_TERM_FORCE_TIME, 176, 1, "Master asked other processes to stop searching due to reaching time limt %.2f seconds"},
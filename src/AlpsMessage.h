@@ -36,6 +36,7 @@
     round among processes. */
 enum ALPS_Message
 {
+    ALPS_CHECKPOINT_NO_RESTART,
     ALPS_DONATE_AFTER,
     ALPS_DONATE_BEFORE,
     ALPS_DONATE_FAIL,
@@ -52,6 +53,8 @@ enum ALPS_Message
     ALPS_LOADBAL_MASTER,
     ALPS_LOADBAL_MASTER_NO,
     ALPS_LOADBAL_MASTER_PERIOD,
+    ALPS_LOADBAL_TUNE_HUB,
+    ALPS_LOADBAL_TUNE_WORKER,
     ALPS_LOADBAL_WORKER_ASK,
     ALPS_LOADREPORT_MASTER,
     ALPS_LOADREPORT_MASTER_F,
@@ -75,6 +78,7 @@ enum ALPS_Message
     ALPS_RAMPUP_MASTER_NODES_AUTO,
     ALPS_RAMPUP_MASTER_SOL,
     ALPS_RAMPUP_MASTER_START,
+    ALPS_RAMPUP_RACE,
     ALPS_RAMPUP_WORKER_RECV,
     ALPS_RAMPUP_WORKER_SOL,
     ALPS_SEARCH_WORKER_START,
@@ -82,6 +86,7 @@ enum ALPS_Message
     ALPS_SOLUTION_SEARCH,
     ALPS_STATIC_BALANCE_BEG,
     ALPS_STATIC_BALANCE_END,
+    ALPS_SUBMASTER_DECENTRAL_TERM,
     ALPS_TERM_FORCE_NODE,
     ALPS_TERM_FORCE_SOL,
     ALPS_TERM_FORCE_TIME,
@@ -156,9 +156,11 @@ enum AlpsMessageTag{
   // 29
   AlpsMsgTellHubRecv,
 
+  /** Not used. Node indices are allocated locally, see AlpsNodeIndex_t. */
   // 30
   AlpsMsgIndicesFromMaster,
 
+  /** Not used. */
   // 31
   AlpsMsgWorkerAskIndices,
 
@@ -211,8 +213,21 @@ enum AlpsMessageTag{
   // 44
   AlpsMsgFinishInitHub,
 
+  /** A chunk of the model in the pipelined model broadcast. */
+  // 45
+  AlpsMsgModelChunk,
+
   /** Error code. */
-  AlpsMsgErrorCode
+  AlpsMsgErrorCode,
+
+  /** Several small messages to the same process sent as one. */
+  // 47
+  AlpsMsgEnvelope,
+  /** An idle worker asks a random worker for a subtree. */
+  // 48
+  AlpsMsgStealRequest,
+  /** Number of tags, not a message. */
+  AlpsMsgEndOfTags
 };
 
 #endif
@@ -222,6 +222,10 @@ public:
   /** Unpack and store shared knowledge from an encoded object. */
   virtual void unpackSharedKnowledge(AlpsEncoded&)
   { /* Default does nothing */ }
+  /** Vary the search parameters for the racer with the given seed in the
+      racing ramp-up. Seed 0 must keep the user's parameters. When the race
+      is decided, every process is called with the seed of the winner. */
+  virtual void setRacingSeed(int) { /* Default does nothing */ }
   //@}
 };
 #endif
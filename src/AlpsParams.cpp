@@ -41,14 +41,32 @@ void AlpsParams::createKeywordList() {
 
    keys_.push_back(make_pair(std::string("Alps_checkMemory"),
                               AlpsParameter(AlpsBoolPar, checkMemory)));
+   keys_.push_back(make_pair(std::string("Alps_checkpointRestart"),
+                             AlpsParameter(AlpsBoolPar, checkpointRestart)));
+   keys_.push_back(make_pair(std::string("Alps_coalesceMessages"),
+                            AlpsParameter(AlpsBoolPar, coalesceMessages)));
+   keys_.push_back(make_pair(std::string("Alps_decentralTermination"),
+                            AlpsParameter(AlpsBoolPar, decentralTermination)));
    keys_.push_back(make_pair(std::string("Alps_deleteDeadNode"),
                              AlpsParameter(AlpsBoolPar, deleteDeadNode)));
+   keys_.push_back(make_pair(std::string("Alps_frontierDonation"),
+                            AlpsParameter(AlpsBoolPar, frontierDonation)));
+   keys_.push_back(make_pair(std::string("Alps_incumbentWindow"),
+                            AlpsParameter(AlpsBoolPar, incumbentWindow)));
    keys_.push_back(make_pair(std::string("Alps_interClusterBalance"),
                             AlpsParameter(AlpsBoolPar, interClusterBalance)));
    keys_.push_back(make_pair(std::string("Alps_intraClusterBalance"),
                             AlpsParameter(AlpsBoolPar, intraClusterBalance)));
    keys_.push_back(make_pair(std::string("Alps_printSolution"),
                              AlpsParameter(AlpsBoolPar, printSolution)));
+   keys_.push_back(make_pair(std::string("Alps_profileMessages"),
+                            AlpsParameter(AlpsBoolPar, profileMessages)));
+   keys_.push_back(make_pair(std::string("Alps_selfTuneBalance"),
+                            AlpsParameter(AlpsBoolPar, selfTuneBalance)));
+   keys_.push_back(make_pair(std::string("Alps_sharedSubTreeTransfer"),
+                            AlpsParameter(AlpsBoolPar, sharedSubTreeTransfer)));
+   keys_.push_back(make_pair(std::string("Alps_topologyClusters"),
+                            AlpsParameter(AlpsBoolPar, topologyClusters)));
    keys_.push_back(make_pair(std::string("Alps_deletePrunedNodes"),
 			     AlpsParameter(AlpsBoolPar, deletePrunedNodes)));
 
@@ -64,6 +82,10 @@ void AlpsParams::createKeywordList() {
                              AlpsParameter(AlpsIntPar,
                                            clockType)));
    //
+   keys_.push_back(make_pair(std::string("Alps_dynamicBalanceScheme"),
+                             AlpsParameter(AlpsIntPar,
+                                           dynamicBalanceScheme)));
+   //
    keys_.push_back(make_pair(std::string("Alps_eliteSize"),
                              AlpsParameter(AlpsIntPar,
                                            eliteSize)));
@@ -80,6 +102,18 @@ void AlpsParams::createKeywordList() {
                              AlpsParameter(AlpsIntPar,
                                            hubNum)));
    //
+   keys_.push_back(make_pair(std::string("Alps_knowledgeBudget"),
+                             AlpsParameter(AlpsIntPar,
+                                           knowledgeBudget)));
+   //
+   keys_.push_back(make_pair(std::string("Alps_knowledgeDedupSize"),
+                             AlpsParameter(AlpsIntPar,
+                                           knowledgeDedupSize)));
+   //
+   keys_.push_back(make_pair(std::string("Alps_knowledgeTopology"),
+                             AlpsParameter(AlpsIntPar,
+                                           knowledgeTopology)));
+   //
    keys_.push_back(make_pair(std::string("Alps_largeSize"),
                              AlpsParameter(AlpsIntPar,
                                            largeSize)));
@@ -104,6 +138,9 @@ void AlpsParams::createKeywordList() {
                              AlpsParameter(AlpsIntPar,
                                            mediumSize)));
    //
+   keys_.push_back(make_pair(std::string("Alps_modelChunkSize"),
+                             AlpsParameter(AlpsIntPar, modelChunkSize)));
+   //
    keys_.push_back(make_pair(std::string("Alps_msgLevel"),
                              AlpsParameter(AlpsIntPar,
                                            msgLevel)));
@@ -124,6 +161,14 @@ void AlpsParams::createKeywordList() {
                              AlpsParameter(AlpsIntPar,
                                            processNum)));
    //
+   keys_.push_back(make_pair(std::string("Alps_racingNodeLimit"),
+                             AlpsParameter(AlpsIntPar,
+                                           racingNodeLimit)));
+   //
+   keys_.push_back(make_pair(std::string("Alps_racingNodeNum"),
+                             AlpsParameter(AlpsIntPar,
+                                           racingNodeNum)));
+   //
    keys_.push_back(make_pair(std::string("Alps_staticBalanceScheme"),
                              AlpsParameter(AlpsIntPar,
                                            staticBalanceScheme)));
@@ -144,6 +189,14 @@ void AlpsParams::createKeywordList() {
                              AlpsParameter(AlpsIntPar,
                                            solLimit)));
    //
+   keys_.push_back(make_pair(std::string("Alps_solutionStreamFormat"),
+                             AlpsParameter(AlpsIntPar,
+                                           solutionStreamFormat)));
+   //
+   keys_.push_back(make_pair(std::string("Alps_subMasterNum"),
+                             AlpsParameter(AlpsIntPar,
+                                           subMasterNum)));
+   //
    keys_.push_back(make_pair(std::string("Alps_unitWorkNodes"),
                              AlpsParameter(AlpsIntPar,
                                            unitWorkNodes)));
@@ -173,6 +226,10 @@ void AlpsParams::createKeywordList() {
                              AlpsParameter(AlpsDoublePar,
                                            hubReportPeriod)));
    //
+   keys_.push_back(make_pair(std::string("Alps_knowledgeBudgetPeriod"),
+                             AlpsParameter(AlpsDoublePar,
+                                           knowledgeBudgetPeriod)));
+   //
    keys_.push_back(make_pair(std::string("Alps_zeroLoad"),
                              AlpsParameter(AlpsDoublePar, zeroLoad)));
    //
@@ -183,9 +240,19 @@ void AlpsParams::createKeywordList() {
                              AlpsParameter(AlpsDoublePar,
                                            changeWorkThreshold)));
    //
+   keys_.push_back(make_pair(std::string("Alps_checkpointCompactFactor"),
+                             AlpsParameter(AlpsDoublePar,
+                                           checkpointCompactFactor)));
+   //
+   keys_.push_back(make_pair(std::string("Alps_checkpointInterval"),
+                             AlpsParameter(AlpsDoublePar, checkpointInterval)));
+   //
    keys_.push_back(make_pair(std::string("Alps_donorThreshold"),
                              AlpsParameter(AlpsDoublePar, donorThreshold)));
    //
+   keys_.push_back(make_pair(std::string("Alps_racingTimeLimit"),
+                             AlpsParameter(AlpsDoublePar, racingTimeLimit)));
+   //
    keys_.push_back(make_pair(std::string("Alps_receiverThreshold"),
                              AlpsParameter(AlpsDoublePar, receiverThreshold)));
    //
@@ -196,11 +263,26 @@ void AlpsParams::createKeywordList() {
    // StringPar
    //-------------------------------------------------------
 
+   keys_.push_back(make_pair(std::string("Alps_checkpointFile"),
+                             AlpsParameter(AlpsStringPar, checkpointFile)));
+   ///
+   keys_.push_back(make_pair(std::string("Alps_eventLogFile"),
+                             AlpsParameter(AlpsStringPar, eventLogFile)));
+   ///
    keys_.push_back(make_pair(std::string("Alps_instance"),
                              AlpsParameter(AlpsStringPar, instance)));
    ///
    keys_.push_back(make_pair(std::string("Alps_logFile"),
                              AlpsParameter(AlpsStringPar, logFile)));
+   ///
+   keys_.push_back(make_pair(std::string("Alps_modelCacheDir"),
+                             AlpsParameter(AlpsStringPar, modelCacheDir)));
+   ///
+   keys_.push_back(make_pair(std::string("Alps_msgProfileFile"),
+                             AlpsParameter(AlpsStringPar, msgProfileFile)));
+   ///
+   keys_.push_back(make_pair(std::string("Alps_solutionStreamFile"),
+                             AlpsParameter(AlpsStringPar, solutionStreamFile)));
 }
 
 //#############################################################################
@@ -209,44 +291,66 @@ void AlpsParams::setDefaultEntries() {
 
   // CharPar
   setEntry(checkMemory, false);
+  setEntry(checkpointRestart, false);
+  setEntry(coalesceMessages, true);
+  setEntry(decentralTermination, true);
   setEntry(deleteDeadNode, true);
+  setEntry(frontierDonation, false);
+  setEntry(incumbentWindow, true);
   setEntry(interClusterBalance, true);
   setEntry(intraClusterBalance, true);
   setEntry(printSolution, false);
+  setEntry(profileMessages, false);
+  setEntry(selfTuneBalance, false);
+  setEntry(sharedSubTreeTransfer, true);
+  setEntry(topologyClusters, false);
   setEntry(deletePrunedNodes, false);
 
   // IntPar
   setEntry(bufSpare, 256);
   setEntry(clockType, AlpsClockTypeWallClock);
+  setEntry(dynamicBalanceScheme, AlpsHierarchicalBalance);
   setEntry(eliteSize, 1);
   setEntry(hubInitNodeNum, ALPS_NONE);
   setEntry(hubMsgLevel, 0);
   setEntry(hubNum, 1);
+  setEntry(knowledgeBudget, 0);
+  setEntry(knowledgeDedupSize, 1024);
+  setEntry(knowledgeTopology, AlpsKnowledgeTree);
   setEntry(largeSize, 2048576);  // 2M
   setEntry(logFileLevel, 0);
   setEntry(masterInitNodeNum, ALPS_NONE);
   setEntry(masterReportInterval, 10);
   setEntry(hubWorkClusterSizeLimit, 1);// Hub never work
   setEntry(mediumSize, 4096);    // 2^12
+  setEntry(modelChunkSize, 1048576);  // 1M
   setEntry(msgLevel, 2);
   setEntry(nodeLimit, ALPS_INT_MAX);
   setEntry(nodeLogInterval, 100);
   setEntry(printSystemStatus, 1);
   setEntry(processNum, 2);
+  setEntry(racingNodeLimit, 1000);
+  setEntry(racingNodeNum, 30);
   setEntry(staticBalanceScheme, 1);  // Spiral
   setEntry(searchStrategy, AlpsSearchTypeBestFirst);
   setEntry(searchStrategyRampUp, AlpsSearchTypeBestFirst);
   setEntry(smallSize, 1024);      // 2^10
   setEntry(solLimit, ALPS_INT_MAX);
+  setEntry(solutionStreamFormat, 0);  // JSON lines
+  setEntry(subMasterNum, 0);
   setEntry(unitWorkNodes, ALPS_NOT_SET);
   setEntry(workerMsgLevel, 0);
 
   // DoublePar
   setEntry(changeWorkThreshold, 0.05);
+  setEntry(checkpointCompactFactor, 4.0);
+  setEntry(checkpointInterval, 600.0);
   setEntry(donorThreshold, 0.02);
   setEntry(hubReportPeriod, -0.01);// Negative default, user can change
+  setEntry(knowledgeBudgetPeriod, 1.0);
   setEntry(masterBalancePeriod, -0.03);// Negative default, user can change
   setEntry(needWorkThreshold, 2);
+  setEntry(racingTimeLimit, 10.0);
   setEntry(receiverThreshold, 0.02);
   setEntry(timeLimit, ALPS_DBL_MAX);
   setEntry(tolerance, 1.0e-6);
@@ -254,8 +358,13 @@ void AlpsParams::setDefaultEntries() {
   setEntry(zeroLoad, 1.0e-6);
 
   // StringPar
+  setEntry(checkpointFile, "NONE");
+  setEntry(eventLogFile, "NONE");
   setEntry(instance, "NONE");
   setEntry(logFile, "Alps.log");
+  setEntry(modelCacheDir, "NONE");
+  setEntry(msgProfileFile, "NONE");
+  setEntry(solutionStreamFile, "NONE");
 }
 
 //#############################################################################
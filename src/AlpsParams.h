@@ -48,9 +48,35 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
       /** Check memory.
           Default: false */
       checkMemory,
+      /** Resume the search from the checkpoint file instead of the root.
+          Serial only; the parallel search truncates its logs.
+          Default: false */
+      checkpointRestart,
+      /** Batch small messages to the same process (status reports, work
+          requests, incumbents and shared model knowledge) into one message
+          per scheduling round.
+          Default: true. */
+      coalesceMessages,
+      /** Detect termination by counting messages in nonblocking reductions
+          over all processes, instead of having the master pause every
+          process and collect its status. Forced to true when sub-masters
+          are used (subMasterNum).
+          Default: true. */
+      decentralTermination,
       /** Remove dead nodes or not.
           Default: true. */
       deleteDeadNode,
+      /** When a worker donates work, send only open leaf nodes, each with
+          an explicit description, instead of splitting off a subtree with
+          its internal nodes. The receiver makes each node the root of a
+          subtree of its own.
+          Default: false. */
+      frontierDonation,
+      /** Keep the incumbent value and owner in an MPI-3 window on the master
+          that processes update atomically and read between units of work,
+          instead of forwarding it with messages along a binary tree.
+          Default: true. */
+      incumbentWindow,
       /** Master balances the workload of hubs: centralized.
           Default: true. */
       interClusterBalance,
@@ -61,6 +87,26 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
           logFileLevel permits.
           Default: false. */
       printSolution,
+      /** Record for every message tag the number and bytes of messages
+          sent and processed during search, and the time spent packing,
+          processing and waiting for them. The totals over all processes
+          are printed with the search statistics.
+          Default: false. */
+      profileMessages,
+      /** Adjust donorThreshold, receiverThreshold, needWorkThreshold,
+          changeWorkThreshold and the balance periods during the search
+          from measured idle time, message rates and donation success.
+          Default: false. */
+      selfTuneBalance,
+      /** Pass subtrees to workers on the same node through an MPI-3
+          shared memory window instead of sending them.
+          Default: true. */
+      sharedSubTreeTransfer,
+      /** Form one cluster per shared memory node: the lowest rank on each
+          node is its hub and the other local ranks are its workers, so
+          that intra-cluster messages stay on the node. hubNum is ignored.
+          Default: false. */
+      topologyClusters,
       /** Warm start or not. 
 	  Default: false. */
       deletePrunedNodes,
@@ -78,6 +124,13 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
           CPU or Wallclock.
           default: wallclock */
       clockType,
+      /** Dynamic load balancing scheme.
+          0: hierarchical, workers report to hubs and hubs to the master,
+             which pair donors and receivers.
+          1: work stealing, idle workers ask random workers, and hubs that
+             process nodes, for subtrees.
+          Default: 0 */
+      dynamicBalanceScheme,
       /** Number of the "elite" nodes that are used in determining workload.
           Default: 1 */
       eliteSize,
@@ -92,6 +145,28 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
       /** The number of hubs.
           Default: 1 */
       hubNum,
+      /** The number of bytes of shared model knowledge a process may
+          send during one knowledgeBudgetPeriod. Knowledge generated after
+          the budget is used up waits in the model until the next period.
+          Forwarded knowledge counts against the budget but is never held.
+          0 means no limit.
+          Default: 0 */
+      knowledgeBudget,
+      /** The number of content hashes of recently shared model knowledge
+          a process remembers. Knowledge seen before is neither sent,
+          stored nor forwarded again. 0 disables duplicate suppression.
+          Default: 1024 */
+      knowledgeDedupSize,
+      /** Topology along which generated model knowledge is shared
+          during search.
+          -- binary tree rooted at the generator (0)
+          -- ring (1)
+          -- hypercube, a binomial tree rooted at the generator (2)
+          -- random gossip to two processes, log2(processNum) hops (3)
+          -- hub-mediated, through the hub of the generator and then
+             the other hubs (4)
+          Default: 0 */
+      knowledgeTopology,
       /** The size of memory allocated for large size message.
           Default: 10485760 */
       largeSize,
@@ -112,6 +187,11 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
       /** The size of memory allocated for medium size message.
           Default: 4096 */
       mediumSize,
+      /** The size (bytes) of the chunks in which the model is broadcast.
+          Chunks are forwarded along a binary tree as soon as they arrive,
+          so large models are pipelined.
+          Default: 1048576 (1M) */
+      modelChunkSize,
       /** The level of printing messages on screen. Used to control master and
           general messages.
           (0: no print to screen; 1: summary; 2: moderate; 3: verbose)
@@ -130,9 +210,19 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
           Default: 2
           Not used since can get actual number of processes from MPI. */
       processNum,
+      /** The maximum number of nodes each process processes in the
+          racing ramp-up. The race is decided when a racer reaches it, even
+          if it has fewer than racingNodeNum open nodes.
+          Default: 1000 */
+      racingNodeLimit,
+      /** The number of open nodes each process generates from the root in
+          the racing ramp-up before the race is decided.
+          Default: 30 */
+      racingNodeNum,
       /** Static load balancing scheme
           -- root initialization (0)
           -- spiral (1)
+          -- racing ramp-up followed by root initialization (2)
       */
       staticBalanceScheme,
       /** Search strategy
@@ -151,6 +241,21 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
       /** The max num of solution can be stored in a solution pool.
           Default: ALPS_INT_MAX */
       solLimit,
+      /** Format of the solution stream
+          -- JSON lines (0)
+          -- binary (1)
+          Default: 0 */
+      solutionStreamFormat,
+      /** The number of sub-masters between the master and the hubs. The
+          hubs are split into subMasterNum + 1 groups of consecutive hubs;
+          the master leads the first group and the first hub of every
+          other group is its sub-master. A hub reports to and is balanced
+          by the leader of its group, and the master balances the groups.
+          0 keeps the two-level hierarchy. Requires decentralized
+          termination: with sub-masters, decentralTermination is set to
+          true, overriding the user's value.
+          Default: 0 */
+      subMasterNum,
       /** The size/number of nodes of a unit work.
           Default: 50 */
       unitWorkNodes,
@@ -170,6 +275,13 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
           that is working on.
           Default: 0.05 */
       changeWorkThreshold,
+      /** The checkpoint log is compacted when its size exceeds this factor
+          times the size of the live subtrees and solutions.
+          Default: 4.0 */
+      checkpointCompactFactor,
+      /** The time period (sec) between two checkpoints.
+          Default: 600 */
+      checkpointInterval,
       /** It is between 1.0 - infty. When the workload in process is more than
           the average workload timing donorThreshold, it is a donor in load
           balancing.
@@ -178,12 +290,20 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
       /** The time period (sec) for hubs to process messages.
           Default: 0.1 */
       hubReportPeriod,
+      /** The time period (sec) over which knowledgeBudget is counted.
+          Default: 1.0 */
+      knowledgeBudgetPeriod,
       /** The time period for master to do loading balance/termination check.
           Default: 0.05 */
       masterBalancePeriod,
       /** The threshold of workload below which a process will ask for workload
           Default: 2 */
       needWorkThreshold,
+      /** The maximum wall clock time (in seconds) each process spends in
+          the racing ramp-up. The race also ends at the time limit of the
+          search.
+          Default: 10 */
+      racingTimeLimit,
       /** It is between 0.0 - 1.0. When the workload in process is less than
           the average workload timing receiverThreshold, it is a receiver.
           Default: 0.1 */
@@ -207,12 +327,39 @@ class ALPSLIB_EXPORT AlpsParams : public AlpsParameterSet {
   /** String parameters. */
   enum strParams
   {
+      /** The checkpoint log file. Checkpointing is disabled if "NONE".
+          In parallel, each process appends its rank to the name.
+          Default: "NONE" */
+      checkpointFile,
+      /** File to which search tree events (node creation, processing and
+          removal) are logged in binary form. In parallel, each process
+          appends its rank to the name. Disabled if "NONE". Logging costs
+          little time but writes about 50 bytes per event, tens of
+          megabytes for a search of a few hundred thousand nodes, so it is
+          not written unless a file is named.
+          Default: "NONE" */
+      eventLogFile,
       /** The instance to be solved.
           Default: "NONE" */
       instance,
       /** The name of log file.
           Default: "Alps.log "*/
       logFile,
+      /** Directory on node-local disk where the encoded model is cached,
+          keyed by a hash of its content. Processes that find the model in
+          the cache do not receive it from the master. Disabled if "NONE".
+          Default: "NONE" */
+      modelCacheDir,
+      /** File to which each process writes its message profile at the
+          end of the search, see profileMessages, which it turns on. Each
+          process appends its rank to the name. Disabled if "NONE".
+          Default: "NONE" */
+      msgProfileFile,
+      /** File to which every improving solution is written as soon as it is
+          found. In parallel, each process appends its rank to the name.
+          Disabled if "NONE".
+          Default: "NONE" */
+      solutionStreamFile,
       ///
       endOfStrParams
   };
@@ -0,0 +1,312 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "AlpsKnowledgeBroker.h"
+#include "AlpsMappedFile.h"
+#include "AlpsReplay.h"
+
+//#############################################################################
+
+AlpsReplayNode&
+AlpsReplayTree::node(AlpsNodeIndex_t index)
+{
+  std::map<AlpsNodeIndex_t, AlpsReplayNode>::iterator pos =
+    nodes_.find(index);
+  if (pos == nodes_.end()) {
+    AlpsReplayNode rn;
+    rn.parentIndex = -1;
+    rn.depth = -1;
+    rn.status = -1;     // Not seen yet.
+    rn.quality = ALPS_OBJ_MAX;
+    pos = nodes_.insert(std::make_pair(index, rn)).first;
+  }
+  return pos->second;
+}
+
+//#############################################################################
+
+void
+AlpsReplayTree::load(const std::string& fileName)
+{
+  AlpsMappedFile file(fileName);
+
+  const long headerSize = static_cast<long>(sizeof(AlpsEventLogHeader));
+  const long recordSize = static_cast<long>(sizeof(AlpsEventRecord));
+
+  AlpsEventLogHeader header;
+  if (file.length() < headerSize) {
+    throw CoinError("Event log is missing or empty", "load",
+                    "AlpsReplayTree");
+  }
+  memcpy(&header, file.data(), headerSize);
+  if (header.magic != ALPS_EVENT_LOG_MAGIC ||
+      header.recordSize != recordSize) {
+    throw CoinError("Not an event log of this version", "load",
+                    "AlpsReplayTree");
+  }
+
+  // Solutions are logged while a node is processed, so before the
+  // process event they belong to.
+  std::map<AlpsNodeIndex_t, double> pendingSolutions;
+  std::map<AlpsNodeIndex_t, double>::iterator solPos;
+
+  AlpsEventRecord rec;
+  AlpsReplayStep step;
+  long offset = headerSize;
+
+  for ( ; offset + recordSize <= file.length(); offset += recordSize) {
+    memcpy(&rec, file.data() + offset, recordSize);
+
+    switch (rec.event) {
+    case AlpsEventCreate: {
+      AlpsReplayNode& rn = node(rec.index);
+      rn.parentIndex = rec.parentIndex;
+      rn.depth = rec.depth;
+      rn.status = rec.toStatus;
+      rn.quality = rec.quality;
+      node(rec.parentIndex).children.push_back(rec.index);
+      break;
+    }
+    case AlpsEventProcess: {
+      AlpsReplayNode& rn = node(rec.index);
+      if (rn.status < 0) {
+        // Not created by branching: the root, or a node of another
+        // process's log.
+        rn.parentIndex = rec.parentIndex;
+        rn.depth = rec.depth;
+        rn.status = rec.fromStatus;
+        if (rec.parentIndex < 0) {
+          rootIndex_ = rec.index;
+        }
+      }
+      if (rec.fromStatus == AlpsNodeStatusPregnant) {
+        // Branching, replayed by the children.
+        break;
+      }
+      step.status = rec.toStatus;
+      step.quality = rec.quality;
+      step.duration = rec.duration;
+      step.solutionValue = ALPS_OBJ_MAX;
+      solPos = pendingSolutions.find(rec.index);
+      if (solPos != pendingSolutions.end()) {
+        step.solutionValue = solPos->second;
+        pendingSolutions.erase(solPos);
+      }
+      rn.steps.push_back(step);
+      break;
+    }
+    case AlpsEventSolution:
+      if (rec.index >= 0) {
+        solPos = pendingSolutions.find(rec.index);
+        if (solPos == pendingSolutions.end() ||
+            rec.quality < solPos->second) {
+          pendingSolutions[rec.index] = rec.quality;
+        }
+      }
+      break;
+    case AlpsEventRemove:
+      break;
+    default:
+      throw CoinError("Unknown event", "load", "AlpsReplayTree");
+    }
+  }
+}
+
+//#############################################################################
+
+void
+AlpsReplayModel::charge(double duration)
+{
+  ++numSteps_;
+  if (timeMode_ == AlpsReplayTimeNone) {
+    return;
+  }
+  replayTime_ += duration;
+  if (timeMode_ == AlpsReplayTimeSleep && duration > 0.0) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+  }
+}
+
+//#############################################################################
+
+void
+AlpsReplayModel::readInstance(const char* dataFile)
+{
+  setDataFile(dataFile);
+
+  std::string files(dataFile);
+  std::string::size_type begin = 0, end;
+  do {
+    end = files.find(',', begin);
+    tree_.load(files.substr(begin, end == std::string::npos ?
+                            std::string::npos : end - begin));
+    begin = end + 1;
+  } while (end != std::string::npos);
+
+  if (tree_.getRootIndex() < 0) {
+    throw CoinError("Event log does not contain the root", "readInstance",
+                    "AlpsReplayModel");
+  }
+}
+
+//#############################################################################
+
+AlpsTreeNode*
+AlpsReplayModel::createRoot()
+{
+  return new AlpsReplayTreeNode(this, tree_.getRootIndex());
+}
+
+//#############################################################################
+
+void
+AlpsReplayModel::modelLog()
+{
+  if (broker_ == NULL || broker_->getMsgLevel() < 1) {
+    return;
+  }
+  std::cout << "Replay: recorded nodes = " << tree_.getNumNodes()
+            << ", replayed steps = " << numSteps_;
+  if (timeMode_ != AlpsReplayTimeNone) {
+    std::cout << ", replay time = " << replayTime_
+              << ", best found at = " << bestTime_;
+  }
+  std::cout << std::endl;
+}
+
+//#############################################################################
+
+AlpsTreeNode*
+AlpsReplayTreeNode::createNewTreeNode(AlpsNodeDesc*& desc) const
+{
+  AlpsReplayNodeDesc* d = dynamic_cast<AlpsReplayNodeDesc*>(desc);
+  AlpsReplayTreeNode* node = new AlpsReplayTreeNode(d);
+  desc = NULL;
+  return node;
+}
+
+//#############################################################################
+
+int
+AlpsReplayTreeNode::process(bool isRoot, bool rampUp)
+{
+  AlpsReplayNodeDesc* desc = dynamic_cast<AlpsReplayNodeDesc*>(desc_);
+  AlpsReplayModel* model = desc->model();
+  const AlpsReplayNode* rec =
+    model->getTree().getNode(desc->getRecordedIndex());
+  const int stepIndex = desc->getNextStep();
+
+  if (rec == NULL || stepIndex >= static_cast<int>(rec->steps.size())) {
+    // Not processed in the recorded search: pruned or left at a limit.
+    setStatus(AlpsNodeStatusFathomed);
+    return 0;
+  }
+
+  const AlpsReplayStep& step = rec->steps[stepIndex];
+  desc->setNextStep(stepIndex + 1);
+  model->charge(step.duration);
+  quality_ = step.quality;
+
+  int foundSolution = 0;
+  if (step.solutionValue < broker()->getIncumbentValue()) {
+    AlpsReplaySolution* sol =
+      new AlpsReplaySolution(step.solutionValue, desc->getRecordedIndex());
+    broker()->addKnowledge(AlpsKnowledgeTypeSolution, sol,
+                           step.solutionValue);
+    model->markBest();
+    foundSolution = 1;
+  }
+
+  AlpsNodeStatus status = static_cast<AlpsNodeStatus>(step.status);
+  if (status == AlpsNodeStatusPregnant && rec->children.empty()) {
+    // The recorded search stopped before branching on it.
+    status = AlpsNodeStatusFathomed;
+  }
+  if ((status == AlpsNodeStatusPregnant ||
+       status == AlpsNodeStatusEvaluated) &&
+      quality_ >= broker()->getIncumbentValue()) {
+    status = AlpsNodeStatusFathomed;
+  }
+  setStatus(status);
+
+  return foundSolution;
+}
+
+//#############################################################################
+
+std::vector< CoinTriple<AlpsNodeDesc*, AlpsNodeStatus, double> >
+AlpsReplayTreeNode::branch()
+{
+  AlpsReplayNodeDesc* desc = dynamic_cast<AlpsReplayNodeDesc*>(desc_);
+  AlpsReplayModel* model = desc->model();
+  const AlpsReplayNode* rec =
+    model->getTree().getNode(desc->getRecordedIndex());
+
+  std::vector< CoinTriple<AlpsNodeDesc*, AlpsNodeStatus, double> > newNodes;
+  if (rec == NULL) {
+    return newNodes;
+  }
+
+  std::vector<AlpsNodeIndex_t>::const_iterator pos;
+  for (pos = rec->children.begin(); pos != rec->children.end(); ++pos) {
+    const AlpsReplayNode* child = model->getTree().getNode(*pos);
+    AlpsNodeDesc* childDesc = new AlpsReplayNodeDesc(model, *pos);
+    newNodes.push_back(CoinMakeTriple(childDesc,
+                                      static_cast<AlpsNodeStatus>
+                                      (child->status),
+                                      child->quality));
+  }
+
+  return newNodes;
+}
+
+//#############################################################################
+
+AlpsKnowledge*
+AlpsReplayTreeNode::decode(AlpsEncoded& encoded) const
+{
+  AlpsReplayNodeDesc* desc = dynamic_cast<AlpsReplayNodeDesc*>(desc_);
+  AlpsReplayTreeNode* node = new AlpsReplayTreeNode(desc->model());
+  node->decodeToSelf(encoded);
+  return node;
+}
+
+//#############################################################################
+
+void
+AlpsReplaySolution::print(std::ostream& os) const
+{
+  os << "Solution of value " << value_ << " found at recorded node "
+     << recordedIndex_ << std::endl;
+}
+
+//#############################################################################
@@ -0,0 +1,332 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#ifndef AlpsReplay_h_
+#define AlpsReplay_h_
+
+#include "AlpsConfig.h"
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CoinError.hpp"
+
+#include "Alps.h"
+#include "AlpsEventLog.h"
+#include "AlpsModel.h"
+#include "AlpsNodeDesc.h"
+#include "AlpsSolution.h"
+#include "AlpsTreeNode.h"
+
+//#############################################################################
+// Replaying a recorded search.
+//
+// A search tree recorded by AlpsEventLog (Alps_eventLogFile) can be searched
+// again without the original application: each node reports the outcome and
+// processing time it had in the recorded run. This makes it cheap to compare
+// node selection rules, eliteSize or diving settings on real trees:
+//
+//   AlpsReplayModel model;
+//   AlpsKnowledgeBrokerSerial broker(argc, argv, model);  // reads the log
+//   broker.registerClass(AlpsKnowledgeTypeSolution,
+//                        new AlpsReplaySolution());
+//   broker.registerClass(AlpsKnowledgeTypeNode, new AlpsReplayTreeNode(&model));
+//   broker.search(&model);
+//
+// with Alps_instance naming the event log (several logs of a parallel run
+// can be given separated by commas). Only nodes that were created in the
+// recorded run exist in the replay. A node that is pruned earlier than in
+// the recorded run is fathomed, but a node the recorded run pruned stays
+// fathomed, since its subtree is unknown.
+//#############################################################################
+
+/** One call of AlpsTreeNode::process() in the recorded search. */
+struct AlpsReplayStep {
+  /** Status after processing (AlpsNodeStatus). */
+  int status;
+  /** Quality after processing. */
+  double quality;
+  /** Seconds spent processing. */
+  double duration;
+  /** Value of the best solution found while processing, ALPS_OBJ_MAX if
+      none. */
+  double solutionValue;
+};
+
+/** A node of the recorded search. */
+struct AlpsReplayNode {
+  /** Index of the parent, -1 for the root. */
+  AlpsNodeIndex_t parentIndex;
+  /** Depth of the node. */
+  int depth;
+  /** Status given to the node when it was created (AlpsNodeStatus). */
+  int status;
+  /** Quality given to the node when it was created. */
+  double quality;
+  /** The calls of process() on this node, in order. */
+  std::vector<AlpsReplayStep> steps;
+  /** Recorded indices of the children, in order of creation. */
+  std::vector<AlpsNodeIndex_t> children;
+};
+
+//#############################################################################
+
+/** A search tree loaded from one or more event logs. */
+class ALPSLIB_EXPORT AlpsReplayTree {
+
+ private:
+
+  /** Recorded nodes keyed by recorded index. */
+  std::map<AlpsNodeIndex_t, AlpsReplayNode> nodes_;
+  /** Recorded index of the root, -1 if not seen. */
+  AlpsNodeIndex_t rootIndex_;
+
+  /** Get the node with given index, creating it if needed. */
+  AlpsReplayNode& node(AlpsNodeIndex_t index);
+
+ public:
+  AlpsReplayTree() : rootIndex_(-1) {}
+
+  /** Add the events of the given log. */
+  void load(const std::string& fileName);
+
+  /** Get the node with given recorded index, NULL if unknown. */
+  const AlpsReplayNode* getNode(AlpsNodeIndex_t index) const {
+    std::map<AlpsNodeIndex_t, AlpsReplayNode>::const_iterator pos =
+      nodes_.find(index);
+    return pos == nodes_.end() ? NULL : &(pos->second);
+  }
+
+  /** Get the recorded index of the root. */
+  AlpsNodeIndex_t getRootIndex() const { return rootIndex_; }
+
+  /** Get the number of recorded nodes. */
+  int getNumNodes() const { return static_cast<int>(nodes_.size()); }
+};
+
+//#############################################################################
+
+/** How the recorded processing time of a node is spent in a replay. */
+enum AlpsReplayTimeMode {
+  /** Ignore it. */
+  AlpsReplayTimeNone = 0,
+  /** Add it to the replay clock only. */
+  AlpsReplayTimeCharge,
+  /** Add it to the replay clock and sleep for it, so that time limits and
+      unit work times behave as in the recorded run. */
+  AlpsReplayTimeSleep
+};
+
+/** The model of a replayed search. */
+class ALPSLIB_EXPORT AlpsReplayModel : public AlpsModel {
+
+ private:
+
+  /** The recorded search. */
+  AlpsReplayTree tree_;
+  /** One of AlpsReplayTimeMode. */
+  int timeMode_;
+  /** Recorded processing time of the nodes processed so far. */
+  double replayTime_;
+  /** Replay time when the best solution was found. */
+  double bestTime_;
+  /** Number of process() calls replayed. */
+  int numSteps_;
+
+  AlpsReplayModel(const AlpsReplayModel&);
+  AlpsReplayModel& operator=(const AlpsReplayModel&);
+
+ public:
+  AlpsReplayModel()
+    :
+    timeMode_(AlpsReplayTimeCharge),
+    replayTime_(0.0),
+    bestTime_(0.0),
+    numSteps_(0) {}
+
+  /** Get the recorded search. */
+  const AlpsReplayTree& getTree() const { return tree_; }
+
+  /** @name Replay time */
+  //@{
+  void setTimeMode(int mode) { timeMode_ = mode; }
+  int getTimeMode() const { return timeMode_; }
+  /** Spend the recorded processing time of a step. */
+  void charge(double duration);
+  /** Note that a better solution was found at the current replay time. */
+  void markBest() { bestTime_ = replayTime_; }
+  double getReplayTime() const { return replayTime_; }
+  double getBestTime() const { return bestTime_; }
+  int getNumSteps() const { return numSteps_; }
+  //@}
+
+  /** Load the event logs named in dataFile, separated by commas. */
+  virtual void readInstance(const char* dataFile);
+
+  /** Create the root with the recorded root's outcome. */
+  virtual AlpsTreeNode* createRoot();
+
+  /** Print replay statistics. */
+  virtual void modelLog();
+
+  using AlpsKnowledge::decode;
+  /** Replays run on one process only. */
+  virtual AlpsKnowledge* decode(AlpsEncoded& encoded) const {
+    throw CoinError("Replay model cannot be sent", "decode",
+                    "AlpsReplayModel");
+  }
+};
+
+//#############################################################################
+
+/** Points a replayed node to its recorded node. */
+class ALPSLIB_EXPORT AlpsReplayNodeDesc : public AlpsNodeDesc {
+
+ private:
+
+  /** The model. */
+  AlpsReplayModel* model_;
+  /** Index of the node in the recorded search. */
+  AlpsNodeIndex_t recordedIndex_;
+  /** Next recorded step to replay. */
+  int nextStep_;
+
+ public:
+  AlpsReplayNodeDesc(AlpsReplayModel* model, AlpsNodeIndex_t recordedIndex)
+    :
+    model_(model),
+    recordedIndex_(recordedIndex),
+    nextStep_(0) {}
+
+  AlpsReplayModel* model() { return model_; }
+  AlpsNodeIndex_t getRecordedIndex() const { return recordedIndex_; }
+  int getNextStep() const { return nextStep_; }
+  void setNextStep(int step) { nextStep_ = step; }
+
+  using AlpsKnowledge::encode;
+  virtual AlpsReturnStatus encode(AlpsEncoded* encoded) const {
+    encoded->writeRep(recordedIndex_);
+    encoded->writeRep(nextStep_);
+    return AlpsReturnStatusOk;
+  }
+  virtual AlpsReturnStatus decodeToSelf(AlpsEncoded& encoded) {
+    encoded.readRep(recordedIndex_);
+    encoded.readRep(nextStep_);
+    return AlpsReturnStatusOk;
+  }
+  virtual AlpsKnowledge* decode(AlpsEncoded& encoded) const {
+    AlpsReplayNodeDesc* desc = new AlpsReplayNodeDesc(model_, -1);
+    desc->decodeToSelf(encoded);
+    return desc;
+  }
+};
+
+//#############################################################################
+
+/** A node that repeats the outcome of its recorded node. */
+class ALPSLIB_EXPORT AlpsReplayTreeNode : public AlpsTreeNode {
+
+ private:
+
+  AlpsReplayTreeNode(const AlpsReplayTreeNode&);
+  AlpsReplayTreeNode& operator=(const AlpsReplayTreeNode&);
+
+ public:
+  /** Create a node for the recorded node with given index. */
+  AlpsReplayTreeNode(AlpsReplayModel* model, AlpsNodeIndex_t index = -1) {
+    desc_ = new AlpsReplayNodeDesc(model, index);
+  }
+  /** Create a node taking over the given description. */
+  AlpsReplayTreeNode(AlpsReplayNodeDesc*& desc) {
+    desc_ = desc;
+    desc = NULL;
+  }
+
+  virtual AlpsTreeNode* createNewTreeNode(AlpsNodeDesc*& desc) const;
+
+  /** Replay the next recorded step: spend its time, report its solution
+      and take its status and quality. A node that is no better than the
+      incumbent is fathomed. */
+  virtual int process(bool isRoot = false, bool rampUp = false);
+
+  /** Create the recorded children. */
+  virtual std::vector< CoinTriple<AlpsNodeDesc*, AlpsNodeStatus, double> >
+  branch();
+
+  using AlpsTreeNode::encode;
+  virtual AlpsKnowledge* decode(AlpsEncoded& encoded) const;
+};
+
+//#############################################################################
+
+/** A solution found in the recorded search. Only its value is known. */
+class ALPSLIB_EXPORT AlpsReplaySolution : public AlpsSolution {
+
+ private:
+
+  /** The value of the solution. */
+  double value_;
+  /** Index of the recorded node where the solution was found. */
+  AlpsNodeIndex_t recordedIndex_;
+
+  AlpsReplaySolution(const AlpsReplaySolution&);
+  AlpsReplaySolution& operator=(const AlpsReplaySolution&);
+
+ public:
+  AlpsReplaySolution(double value = ALPS_OBJ_MAX,
+                     AlpsNodeIndex_t recordedIndex = -1)
+    :
+    value_(value),
+    recordedIndex_(recordedIndex) {}
+
+  double getValue() const { return value_; }
+
+  virtual void print(std::ostream& os) const;
+
+  using AlpsSolution::encode;
+  virtual AlpsReturnStatus encode(AlpsEncoded* encoded) const {
+    AlpsSolution::encode(encoded);
+    encoded->writeRep(value_);
+    encoded->writeRep(recordedIndex_);
+    return AlpsReturnStatusOk;
+  }
+  virtual AlpsReturnStatus decodeToSelf(AlpsEncoded& encoded) {
+    AlpsSolution::decodeToSelf(encoded);
+    encoded.readRep(value_);
+    encoded.readRep(recordedIndex_);
+    return AlpsReturnStatusOk;
+  }
+  virtual AlpsKnowledge* decode(AlpsEncoded& encoded) const {
+    AlpsReplaySolution* sol = new AlpsReplaySolution();
+    sol->decodeToSelf(encoded);
+    return sol;
+  }
+};
+
+#endif
@@ -46,7 +46,7 @@ private:
   AlpsSolution& operator=(const AlpsSolution&);
 
   /** The index of the node where the solution was found. */
-  int index_;
+  AlpsNodeIndex_t index_;
 
   /** The depth of the node where the solution was found. */
   int depth_;
@@ -0,0 +1,134 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+#include "CoinError.hpp"
+
+#include "AlpsEncoded.h"
+#include "AlpsSolutionStream.h"
+#include "AlpsTime.h"
+
+//#############################################################################
+
+/** Append the given text to out as a quoted JSON string. */
+static void appendJsonString(std::string& out, const std::string& text)
+{
+  char hex[8];
+  out += '"';
+  for (std::string::size_type i = 0; i < text.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    switch (c) {
+    case '"':  out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if (c < 0x20) {
+        sprintf(hex, "\\u%04x", c);
+        out += hex;
+      }
+      else {
+        out += static_cast<char>(c);
+      }
+    }
+  }
+  out += '"';
+}
+
+//#############################################################################
+
+AlpsSolutionStream::AlpsSolutionStream(const std::string& fileName,
+                                       int format)
+  :
+  writer_(fileName),
+  format_(format),
+  numSolutions_(0)
+{
+  if (format_ != AlpsSolutionStreamJson &&
+      format_ != AlpsSolutionStreamBinary) {
+    throw CoinError("Unknown solution stream format",
+                    "AlpsSolutionStream", "AlpsSolutionStream");
+  }
+}
+
+//#############################################################################
+
+void
+AlpsSolutionStream::write(const AlpsSolution* sol,
+                          double value,
+                          double time,
+                          AlpsNodeIndex_t index,
+                          int depth,
+                          int rank)
+{
+  double timeOfDay = AlpsGetTimeOfDay();
+
+  if (format_ == AlpsSolutionStreamBinary) {
+    AlpsEncoded* enc = sol->encode();
+
+    AlpsSolutionRecord header;
+    memset(&header, 0, sizeof(AlpsSolutionRecord));
+    header.magic = ALPS_SOLUTION_MAGIC;
+    header.rank = rank;
+    header.index = index;
+    header.depth = depth;
+    header.timeOfDay = timeOfDay;
+    header.time = time;
+    header.value = value;
+    header.knowledgeType = enc->type();
+    header.size = enc->size();
+
+    std::string buffer(reinterpret_cast<const char*>(&header),
+                       sizeof(AlpsSolutionRecord));
+    buffer.append(enc->representation(), enc->size());
+    delete enc;
+    writer_.write(buffer);
+  }
+  else {
+    std::ostringstream text;
+    sol->print(text);
+
+    char fields[256];
+    sprintf(fields, "{\"timeOfDay\":%.6f,\"time\":%.6f,\"rank\":%d,"
+            "\"index\":%lld,\"depth\":%d,\"value\":%.17g,\"solution\":",
+            timeOfDay, time, rank, static_cast<long long>(index), depth,
+            value);
+
+    std::string line(fields);
+    appendJsonString(line, text.str());
+    line += "}\n";
+    writer_.write(line);
+  }
+
+  ++numSolutions_;
+}
+
+//#############################################################################
@@ -0,0 +1,108 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#ifndef AlpsSolutionStream_h_
+#define AlpsSolutionStream_h_
+
+#include "AlpsConfig.h"
+
+#include <string>
+
+#include "Alps.h"
+#include "AlpsAsyncWriter.h"
+#include "AlpsSolution.h"
+
+//#############################################################################
+
+/** Formats of a solution stream. */
+enum AlpsSolutionStreamFormat {
+  /** One JSON object per line; the solution is its printed form. */
+  AlpsSolutionStreamJson = 0,
+  /** An AlpsSolutionRecord followed by the encoded solution. */
+  AlpsSolutionStreamBinary
+};
+
+/** The fixed size header of a solution in a binary solution stream. */
+struct AlpsSolutionRecord {
+  /** Always ALPS_SOLUTION_MAGIC. */
+  int magic;
+  /** Rank of the process that found the solution. */
+  int rank;
+  /** Index of the node where the solution was found. */
+  AlpsNodeIndex_t index;
+  /** Depth of the node where the solution was found. */
+  int depth;
+  /** Unused. */
+  int reserved;
+  /** Time of day (seconds since the epoch) the solution was found. */
+  double timeOfDay;
+  /** Search time when the solution was found. */
+  double time;
+  /** Quality of the solution. */
+  double value;
+  /** Knowledge type of the payload. */
+  int knowledgeType;
+  /** Size of the encoded solution following the header. */
+  int size;
+};
+
+#define ALPS_SOLUTION_MAGIC 0x41534f32 /* "ASO2" */
+
+//#############################################################################
+
+/** Writes solutions to a file while the search is running. Formatting is
+    done by the caller; the file is written by a background thread. */
+class ALPSLIB_EXPORT AlpsSolutionStream {
+
+ private:
+
+  /** The background writer. */
+  AlpsAsyncWriter writer_;
+  /** One of AlpsSolutionStreamFormat. */
+  int format_;
+  /** Number of solutions written. */
+  int numSolutions_;
+
+  AlpsSolutionStream(const AlpsSolutionStream&);
+  AlpsSolutionStream& operator=(const AlpsSolutionStream&);
+
+ public:
+  /** Truncate the given file and start writing to it. */
+  AlpsSolutionStream(const std::string& fileName, int format);
+
+  /** Queue a solution. */
+  void write(const AlpsSolution* sol, double value, double time,
+             AlpsNodeIndex_t index, int depth, int rank);
+
+  /** Write the queued solutions and close the file. */
+  void close() { writer_.close(); }
+
+  /** Get the number of solutions written. */
+  int getNumSolutions() const { return numSolutions_; }
+};
+
+#endif
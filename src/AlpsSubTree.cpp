@@ -28,6 +28,7 @@
 #include <iostream>
 #include <queue>
 #include <stack>
+#include <vector>
 
 #include "CoinError.hpp"
 #include "CoinTime.hpp"
@@ -126,7 +127,9 @@ AlpsSubTree::AlpsSubTree()
   //diveNodePool_(new AlpsNodePool),
   diveNodeRule_(new AlpsNodeSelectionBest),
   activeNode_(0),
-  quality_(ALPS_OBJ_MAX)
+  quality_(ALPS_OBJ_MAX),
+  checkpointId_(-1),
+  checkpointDirty_(true)
 {
   nodePool_ = new AlpsNodePool((AlpsSearchType)broker_->getModel()->AlpsPar()->
                                entry(AlpsParams::searchStrategy));
@@ -149,7 +152,9 @@ AlpsSubTree::AlpsSubTree(AlpsKnowledgeBroker* kb)
   // diveNodePool_(new AlpsNodePool),
   diveNodeRule_(new AlpsNodeSelectionBest),
   activeNode_(0),
-  quality_(ALPS_OBJ_MAX)
+  quality_(ALPS_OBJ_MAX),
+  checkpointId_(-1),
+  checkpointDirty_(true)
 {
   //eliteSize_ = kb->getDataPool()->
   //getOwnParams()->entry(AlpsParams::eliteSize);
@@ -222,20 +227,37 @@ AlpsSubTree::fathomAllNodes()
 
 void
 AlpsSubTree::removeDeadNodes(AlpsTreeNode*& node)
+{
+  removeDeadNodes(node, node->getStatus());
+}
+
+//#############################################################################
+
+void
+AlpsSubTree::removeDeadNodes(AlpsTreeNode*& node, AlpsNodeStatus oldStatus)
 {
   if (!node->isFathomed() && !node->isDiscarded()) {
     throw CoinError("node->isFathomed()","removeDeadNodes","AlpsSubTree");
   }
 
   AlpsTreeNode* parent = node->getParent();
+
+  AlpsEventLog* eventLog = broker_->getEventLog();
+  if (eventLog) {
+    // The root is fathomed below.
+    eventLog->record(AlpsEventRemove, node, oldStatus,
+                     parent ? node->getStatus() : AlpsNodeStatusFathomed);
+  }
+
   if (parent) {
     /* Free memory of node. */
     parent->removeChild(node);
 
     if (parent->getNumChildren() == 0) {
       /* If parent has no child, fathom it. This repeats recursively. */
+      AlpsNodeStatus parentStatus = parent->getStatus();
       parent->setStatus(AlpsNodeStatusFathomed);
-      removeDeadNodes(parent);
+      removeDeadNodes(parent, parentStatus);
     }
   }
   else {
@@ -283,6 +305,7 @@ AlpsSubTree::createChildren(
   const int msgLevel =
     broker_->getModel()->AlpsPar()->entry(AlpsParams::msgLevel);
   const int numChildren = static_cast<int> (children.size());
+  AlpsEventLog* eventLog = broker_->getEventLog();
 
   parent->setNumChildren(numChildren);
 
@@ -309,6 +332,9 @@ AlpsSubTree::createChildren(
     child->setActive(false);
     child->setDepth(parent->getDepth() + 1);
     child->setIndex(nextIndex());
+    if (eventLog) {
+      eventLog->record(AlpsEventCreate, child, -1, child->getStatus());
+    }
     if (msgLevel >= 100){
       std::cout << child->getIndex() << " ";
     }
@@ -349,7 +375,7 @@ AlpsSubTree::createChildren(
 
 //#############################################################################
 
-int
+AlpsNodeIndex_t
 AlpsSubTree::nextIndex()
 {
   return broker_->nextNodeIndex();
@@ -357,7 +383,7 @@ AlpsSubTree::nextIndex()
 
 //#############################################################################
 
-int
+AlpsNodeIndex_t
 AlpsSubTree::getNextIndex() const
 {
   return broker_->getNextNodeIndex();
@@ -366,7 +392,7 @@ AlpsSubTree::getNextIndex() const
 //#############################################################################
 
 void
-AlpsSubTree::setNextIndex(int next)
+AlpsSubTree::setNextIndex(AlpsNodeIndex_t next)
 {
   broker_->setNextNodeIndex(next);
 }
@@ -540,7 +566,9 @@ int
 AlpsSubTree::rampUp(int minNumNodes,
                     int requiredNumNodes,
                     int& depth,
-                    AlpsTreeNode* root)
+                    AlpsTreeNode* root,
+                    int nodeLimit,
+                    double timeLimit)
 {
   int numNodesProcessed = 0;
   int npCount = 0;
@@ -549,9 +577,14 @@ AlpsSubTree::rampUp(int minNumNodes,
   bool firstCall = true;
   bool comRampUpNodes = true;
 
+  checkpointDirty_ = true;
+
   const bool deleteNode =
     broker_->getModel()->AlpsPar()->entry(AlpsParams::deleteDeadNode);
 
+  AlpsEventLog* eventLog = broker_->getEventLog();
+  AlpsNodeStatus oldStatus = AlpsNodeStatusCandidate;
+
   AlpsTreeNode* node = NULL;
 
   if (requiredNumNodes > 0) {
@@ -568,8 +601,12 @@ AlpsSubTree::rampUp(int minNumNodes,
     /* Hub. Do nothing. */
   }
 
+  const double startTime = AlpsGetTimeOfDay();
+
   while( nodePool_->hasKnowledge() &&
-         ((nodePool_->getNumKnowledges() < requiredNumNodes) || firstCall) ) {
+         ((nodePool_->getNumKnowledges() < requiredNumNodes) || firstCall) &&
+         numNodesProcessed < nodeLimit &&
+         AlpsGetTimeOfDay() - startTime < timeLimit ) {
 
     node = dynamic_cast<AlpsTreeNode*>
       (const_cast<AlpsKnowledge*>(nodePool_->getKnowledge().first) );
@@ -586,6 +623,10 @@ AlpsSubTree::rampUp(int minNumNodes,
           depth = node->getDepth() + 1;
         }
       }
+      if (eventLog) {
+        eventLog->record(AlpsEventProcess, node, AlpsNodeStatusPregnant,
+                         node->getStatus());
+      }
       break;
     }
     case AlpsNodeStatusCandidate :
@@ -594,6 +635,7 @@ AlpsSubTree::rampUp(int minNumNodes,
       //activeNode_ = node; // Don't set, getNumNodes wrong.
       broker_->subTreeTimer().start();
       node->setActive(true);
+      oldStatus = node->getStatus();
       if (node == root_) {
         node->process(true, true);
       }
@@ -603,6 +645,10 @@ AlpsSubTree::rampUp(int minNumNodes,
 
       node->setActive(false);
       npTime = broker_->subTreeTimer().getWallClockTime();
+      if (eventLog) {
+        eventLog->record(AlpsEventProcess, node, oldStatus,
+                         node->getStatus(), npTime);
+      }
       if (comRampUpNodes && (npCount < 50)) {
         requiredNumNodes = computeRampUpNumNodes(minNumNodes,
                                                  requiredNumNodes,
@@ -682,6 +728,8 @@ AlpsSubTree::splitSubTree(int& returnSize, int size)
         return st;
     }
 
+    checkpointDirty_ = true;
+
     int i;
     int numChildren = 0;
 
@@ -713,34 +761,13 @@ AlpsSubTree::splitSubTree(int& returnSize, int size)
     AlpsTreeNode* subTreeRoot = 0;
     AlpsTreeNode* rootParent = 0;
 
-    int nodeMemSize = broker_->getNodeMemSize();
-    int LS = broker_->getLargeSize()/2;
-    int maxAllowNodes = LS / nodeMemSize;
-
-    if (maxAllowNodes == 0) {
-        returnSize = 0;
-        return st;
-    }
-
-    // At most send 50 nodes
-    if (nodeMemSize < 10000) {
-        maxAllowNodes = (maxAllowNodes > 100) ? 100 : maxAllowNodes;
-    }
-    else if (nodeMemSize < 50000) {
-        maxAllowNodes = (maxAllowNodes > 50) ? 30 : maxAllowNodes;
-    }
-    else if (nodeMemSize < 100000) {
-        maxAllowNodes = (maxAllowNodes > 30) ? 20 : maxAllowNodes;
-    }
-    else if (nodeMemSize < 500000) {
-        maxAllowNodes = (maxAllowNodes > 10) ? 5 : maxAllowNodes;
-    }
-    else if (nodeMemSize < 1000000) {
-        maxAllowNodes = (maxAllowNodes > 3) ? 3 : maxAllowNodes;
-    }
-    else {
-        maxAllowNodes = 1;
-    }
+    // A split subtree is kept within half the receive buffer, leaving room
+    // for the node headers, so that a donation does not need a buffer of
+    // its own. Larger nodes give fewer nodes per donation; the best leaf
+    // is always sent.
+    const int nodeMemSize = CoinMax(broker_->getNodeMemSize(), 1);
+    const int maxAllowNodes =
+        CoinMax(broker_->getLargeSize() / 2 / nodeMemSize, 1);
 
 #if 0
     //------------------------------------------------------
@@ -832,17 +859,15 @@ AlpsSubTree::splitSubTree(int& returnSize, int size)
                 nodeStack.push(curNode->getChild(i));
             }
         }
+        if (numSendNode > maxAllowNodes) {
+            // Too large, keep the previous subtree.
+            subTreeRoot = preSubTreeRoot;
+            break;
+        }
         // 4.1 looks fine
-        if ((6 * numInPool > numNode) || numSendNode >= maxAllowNodes) {
+        if (6 * numInPool > numNode) {
             break;
         }
-
-        //if (numSendNode > maxAllowNodes) {
-        //  std::cout << "splitSubTree: Too many nodes ("<< numSendNode
-        //      << ") to be sent. Give up" << " this time."<<std::endl;
-        //  returnSize = 0;
-        //  return st;
-        //}
     }
 
 #ifdef NF_DEBUG
@@ -954,6 +979,151 @@ AlpsSubTree::splitSubTree(int& returnSize, int size)
 
 //#############################################################################
 
+AlpsEncoded*
+AlpsSubTree::splitFrontier(int& returnSize, bool whole)
+{
+    returnSize = 0;
+
+    //------------------------------------------------------
+    // Move nodes in diving pool to normal pool.
+    //------------------------------------------------------
+
+    AlpsTreeNode* node = NULL;
+
+    while (diveNodePool_->getNumKnowledges() > 0) {
+        node = dynamic_cast<AlpsTreeNode *>
+            (diveNodePool_->getKnowledge().first);
+        diveNodePool_->popKnowledge();
+        nodePool_->addKnowledge(node, node->getQuality());
+    }
+    if (activeNode_) {
+        nodePool_->addKnowledge(activeNode_, activeNode_->getQuality());
+        activeNode_ = 0;
+    }
+
+    if (nodePool_->getNumKnowledges() < (whole ? 1 : 2)) {
+        return NULL;
+    }
+
+    checkpointDirty_ = true;
+
+    //------------------------------------------------------
+    // Go through the nodes in the order of the node selection rule and
+    // give away every second one, so that both sides get good nodes. A
+    // node without a parent is the root of this subtree and stays.
+    //------------------------------------------------------
+
+    std::vector<AlpsTreeNode*> sendNodes;
+    std::vector<AlpsTreeNode*> keepNodes;
+
+    int k = 0;
+    while (nodePool_->hasKnowledge()) {
+        node = dynamic_cast<AlpsTreeNode*>(nodePool_->getKnowledge().first);
+        nodePool_->popKnowledge();
+        if (whole || (k % 2 == 1 && node->getParent() != NULL)) {
+            sendNodes.push_back(node);
+        }
+        else {
+            keepNodes.push_back(node);
+        }
+        ++k;
+    }
+    for (k = 0; k < static_cast<int>(keepNodes.size()); ++k) {
+        nodePool_->addKnowledge(keepNodes[k], keepNodes[k]->getQuality());
+    }
+
+    returnSize = static_cast<int>(sendNodes.size());
+    if (returnSize == 0) {
+        return NULL;
+    }
+
+    //------------------------------------------------------
+    // Encode the nodes one after another. Unless the whole subtree goes,
+    // remove them from it. Parents left without children are fathomed,
+    // and removed too if dead nodes are deleted.
+    //------------------------------------------------------
+
+    const bool deleteNode =
+        broker_->getModel()->AlpsPar()->entry(AlpsParams::deleteDeadNode);
+
+    AlpsEncoded* encoded = new AlpsEncoded(AlpsKnowledgeTypeNode);
+    encoded->writeRep(returnSize);
+
+    for (k = 0; k < returnSize; ++k) {
+        node = sendNodes[k];
+        node->convertToExplicit();
+        node->setExplicit(1);
+
+        AlpsEncoded* enc = node->encode();
+        encoded->writeRep(node->getQuality());
+        encoded->writeRep(node->getStatus());
+        encoded->writeRep(enc->representation(), enc->size());
+        delete enc;
+
+        if (!whole) {
+            AlpsTreeNode* parent = node->getParent();
+            parent->removeChild(node);
+            if (parent->getNumChildren() == 0) {
+                AlpsNodeStatus oldStatus = parent->getStatus();
+                parent->setStatus(AlpsNodeStatusFathomed);
+                if (deleteNode) {
+                    removeDeadNodes(parent, oldStatus);
+                }
+            }
+        }
+    }
+
+    return encoded;
+}
+
+//#############################################################################
+
+void
+AlpsSubTree::decodeFrontier(AlpsEncoded& encoded,
+                            std::vector<AlpsSubTree*>& subTrees) const
+{
+    int numNodes = 0;
+    int size = 0;
+    char* buf = NULL;
+    double quality = ALPS_OBJ_MAX;
+    AlpsNodeStatus status = AlpsNodeStatusCandidate;
+
+    encoded.readRep(numNodes);
+    if (numNodes <= 0) {
+        throw CoinError("No nodes", "decodeFrontier", "AlpsSubTree");
+    }
+
+    for (int k = 0; k < numNodes; ++k) {
+        encoded.readRep(quality);
+        encoded.readRep(status);
+        if (broker_->isDominated(quality, status)) {
+            encoded.skipRep<char>();
+            broker_->addNumNodesDiscarded(1);
+            continue;
+        }
+
+        // readRep allocates buf, which encodedNode takes over.
+        encoded.readRep(buf, size);
+        AlpsEncoded encodedNode(AlpsKnowledgeTypeNode, size, buf);
+
+        AlpsTreeNode* node = dynamic_cast<AlpsTreeNode* >
+            (broker_->decoderObject(AlpsKnowledgeTypeNode)->
+             decode(encodedNode));
+        node->setBroker(broker_);
+        node->setParent(NULL);
+
+        AlpsSubTree* st = newSubTree();
+        st->setBroker(broker_);
+        st->setNodeSelection(broker_->getNodeSelection());
+        st->setRoot(node);
+        st->nodePool()->addKnowledge(node, node->getQuality());
+        st->calculateQuality();
+        subTrees.push_back(st);
+    }
+}
+
+//#############################################################################
+
 // Encode this into the given AlpsEncoded object.
 AlpsReturnStatus AlpsSubTree::encode(AlpsEncoded * encoded) const {
   std::vector<AlpsTreeNode* > nodesInPool =
@@ -1002,6 +1172,10 @@ AlpsReturnStatus AlpsSubTree::encode(AlpsEncoded * encoded) const {
   for (i = 0; i < nodeNum; ++i) {          // Write all nodes to rep of enc
     node = nodeVector[i];
     encoded->writeRep(node->getExplicit());
+    // Quality and status go ahead of the node so that the receiver can
+    // skip nodes its incumbent prunes without decoding them.
+    encoded->writeRep(node->getQuality());
+    encoded->writeRep(node->getStatus());
     AlpsEncoded* enc = node->encode();
     encoded->writeRep(enc->size());
     encoded->writeRep(enc->representation(), enc->size());
@@ -1030,6 +1204,8 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
   char* buf = 0;
   int size = 0;
   int* numAddedChildren = 0;
+  double quality = ALPS_OBJ_MAX;
+  AlpsNodeStatus status = AlpsNodeStatusCandidate;
 
   AlpsSubTree* st = new AlpsSubTree(broker_);
 
@@ -1059,6 +1235,8 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
 
   for (i = 0; i < nodeNum; ++i) {
     encoded.readRep(fullOrPartial);
+    encoded.readRep(quality);
+    encoded.readRep(status);
     encoded.readRep(size);
 
 #ifdef NF_DEBUG
@@ -1066,6 +1244,13 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
               << "; size = " << size << std::endl;
 #endif
 
+    if (broker_->isDominated(quality, status)) {
+      // Open nodes are leaves, so nothing hangs below it.
+      encoded.skipRep<char>();
+      broker_->addNumNodesDiscarded(1);
+      continue;
+    }
+
     // readRep allocate memory for buf.
     encoded.readRep(buf, size);
 
@@ -1086,7 +1271,7 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
     nodeVector.push_back(node);
 
     if (i == 0) {
-      // First node is root
+      // First node is root; if it was skipped, the subtree is empty.
       st->setRoot(node);
       node->setParent(NULL);
 
@@ -1101,12 +1286,15 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
   // Indentify parent-children relationship.
   //------------------------------------------------------
 
+  const int numDecoded = static_cast<int>(nodeVector.size());
+  std::vector<AlpsTreeNode*> deadNodes;
+
   numAddedChildren = new int [nodeNum];
-  for (i = 0; i < nodeNum; ++i) {
+  for (i = 0; i < numDecoded; ++i) {
     // Allocate memory for children
     nodeVector[i]->setNumChildren(nodeVector[i]->getNumChildren());
     numAddedChildren[i] = 0;
-    for (j = 0; j < nodeNum; ++j) {
+    for (j = 0; j < numDecoded; ++j) {
       if (j != i) {
         if (nodeVector[j]->getParentIndex() ==
             nodeVector[i]->getIndex()) {
@@ -1119,6 +1307,14 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
         }
       }
     }
+    if (numAddedChildren[i] < nodeVector[i]->getNumChildren()) {
+      // Some children were skipped.
+      nodeVector[i]->modifyNumChildren(numAddedChildren[i] -
+                                       nodeVector[i]->getNumChildren());
+      if (numAddedChildren[i] == 0) {
+        deadNodes.push_back(nodeVector[i]);
+      }
+    }
   }
 
   //------------------------------------------------------
@@ -1129,7 +1325,7 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
   int nodeReceived = 0;
   nodeReceived = static_cast<int> (nodeVector.size());
 
-  for (i = 0; i < nodeNum; ++i) {
+  for (i = 0; i < numDecoded; ++i) {
     node = nodeVector.back();
     if (node->getSentMark() == 2) {
       ++nodeAdded;
@@ -1144,6 +1340,22 @@ AlpsKnowledge * AlpsSubTree::decode(AlpsEncoded & encoded) const {
   st->setBroker(broker_);
   st->setNodeSelection(broker_->getNodeSelection());
 
+  //------------------------------------------------------
+  // Nodes left without children are fathomed, as they would be had
+  // their children been pruned here.
+  //------------------------------------------------------
+
+  const bool deleteNode =
+    broker_->getModel()->AlpsPar()->entry(AlpsParams::deleteDeadNode);
+
+  for (i = 0; i < static_cast<int>(deadNodes.size()); ++i) {
+    AlpsNodeStatus oldStatus = deadNodes[i]->getStatus();
+    deadNodes[i]->setStatus(AlpsNodeStatusFathomed);
+    if (deleteNode) {
+      st->removeDeadNodes(deadNodes[i], oldStatus);
+    }
+  }
+
   //------------------------------------------------------
   // Clean up.
   //------------------------------------------------------
@@ -1220,6 +1432,9 @@ AlpsSubTree::exploreUnitWork(bool leaveAsIt,
 
     AlpsSearchStrategy<AlpsTreeNode*> *nodeSel = broker_->getNodeSelection();
 
+    AlpsEventLog* eventLog = broker_->getEventLog();
+    double processStart = 0.0;
+
 #ifdef ALPS_MEMORY_USAGE
     bool checkMemory = broker_->getModel()->AlpsPar()->
         entry(AlpsParams::checkMemory);
@@ -1250,12 +1465,21 @@ AlpsSubTree::exploreUnitWork(bool leaveAsIt,
         numNodesProcessed = 0;
     }
 
+    // A subtree restored from a checkpoint may start with many nodes.
+    numNodesCandidate = nodePool_->getNumKnowledges() +
+        diveNodePool_->getNumKnowledges() - numNodesPartial;
+
     while ( (nodePool_->hasKnowledge() || activeNode_ ||
              diveNodePool_->hasKnowledge()) &&
             !betterSolution ) {
 
       broker_->subTreeTimer().stop();
 
+        // Log the changes since the last checkpoint if it is time.
+        if (broker_->checkpointDue()) {
+            broker_->checkpoint();
+        }
+
 #if 0
         std::cout << "unitTime = " << unitTime
                   << ", solTime = " << broker_->subTreeTimer().getTime()
@@ -1278,6 +1502,7 @@ AlpsSubTree::exploreUnitWork(bool leaveAsIt,
 
 	// Get the next node to be processed.
 	activeNode_ = nodeSel->selectNextNode(this);
+	checkpointDirty_ = true;
 
 	switch (activeNode_->getStatus()) {
 	case AlpsNodeStatusPregnant:
@@ -1296,6 +1521,11 @@ AlpsSubTree::exploreUnitWork(bool leaveAsIt,
 #endif
 	    --numNodesPartial;
 	    ++numNodesProcessed;
+	    if (eventLog) {
+		eventLog->record(AlpsEventProcess, activeNode_,
+				 AlpsNodeStatusPregnant,
+				 activeNode_->getStatus());
+	    }
 	    switch (activeNode_->getStatus()) {
 	    case AlpsNodeStatusBranched :
 		++numNodesBranched;
@@ -1325,6 +1555,9 @@ AlpsSubTree::exploreUnitWork(bool leaveAsIt,
             }else{
                --numNodesCandidate;
             }
+            if (eventLog) {
+                processStart = AlpsGetTimeOfDay();
+            }
             if (activeNode_ == root_) {
                 activeNode_->process(true);
             }
@@ -1333,6 +1566,12 @@ AlpsSubTree::exploreUnitWork(bool leaveAsIt,
             }
             activeNode_->setActive(false);
 
+            if (eventLog) {
+                eventLog->record(AlpsEventProcess, activeNode_, oldStatus,
+                                 activeNode_->getStatus(),
+                                 AlpsGetTimeOfDay() - processStart);
+            }
+
             // Record the new sol quality if have.
             if( broker_->hasKnowledge(AlpsKnowledgeTypeSolution) ) {
                 newSolQuality =
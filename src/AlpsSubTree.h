@@ -31,6 +31,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 
 #include "CoinError.hpp"
 #include "CoinSort.hpp"
@@ -79,6 +80,12 @@ protected:
   /** A quantity indicating how good this subtree is. */
   double quality_;
 
+  /** The id of this subtree in the checkpoint log, -1 if not logged yet. */
+  int checkpointId_;
+
+  /** Whether this subtree changed since it was last checkpointed. */
+  bool checkpointDirty_;
+
 protected:
 
   /** The purpose of this method is to remove nodes that are not needed in
@@ -89,6 +96,11 @@ protected:
       parent. This removes all nodes that are no longer needed. */
   void removeDeadNodes(AlpsTreeNode*& node);
 
+  /** Same as above, but the event log records the transition of the
+      argument node from <code>oldStatus</code>, its status before the
+      caller fathomed it. */
+  void removeDeadNodes(AlpsTreeNode*& node, AlpsNodeStatus oldStatus);
+
   /** This function replaces \c oldNode with \c newNode in the tree. */
   void replaceNode(AlpsTreeNode* oldNode, AlpsTreeNode* newNode);
 
@@ -194,13 +206,13 @@ public:
 
   /* Get the index of the next generated node and increment next index
      by one.*/
-  int nextIndex();
+  AlpsNodeIndex_t nextIndex();
 
   /** Get the index of the next generated node.*/
-  int getNextIndex() const;
+  AlpsNodeIndex_t getNextIndex() const;
 
   /** Set the index of the next generated node. */
-  void setNextIndex(int next);
+  void setNextIndex(AlpsNodeIndex_t next);
 
   /** Return the number of nodes on this subtree. */
   int getNumNodes() const {
@@ -216,6 +228,18 @@ public:
             diveNodePool_->getNumKnowledges());
   }
 
+  /** Get the id of this subtree in the checkpoint log. */
+  int getCheckpointId() const { return checkpointId_; }
+
+  /** Set the id of this subtree in the checkpoint log. */
+  void setCheckpointId(int id) { checkpointId_ = id; }
+
+  /** Query whether this subtree changed since the last checkpoint. */
+  bool getCheckpointDirty() const { return checkpointDirty_; }
+
+  /** Set whether this subtree changed since the last checkpoint. */
+  void setCheckpointDirty(bool dirty) { checkpointDirty_ = dirty; }
+
   /** Set the node comparision rule. */
   void setNodeSelection(AlpsSearchStrategy<AlpsTreeNode*>* nc) {
     nodePool_->setNodeSelection(*nc);
@@ -226,6 +250,20 @@ public:
       specified size or available size. */
   AlpsSubTree* splitSubTree(int& returnSize, int size = 10);
 
+  /** Take open leaf nodes out of the subtree to donate them: every second
+      one in the order of the node selection rule, or all of them if
+      whole is true, in which case the subtree is left unchanged and is
+      to be deleted. Each node is made explicit. Return the nodes encoded
+      one after another and set returnSize to their number, or return
+      NULL if there is nothing to give. */
+  AlpsEncoded* splitFrontier(int& returnSize, bool whole = false);
+
+  /** Make each node encoded by splitFrontier() the root of a new subtree
+      and append the subtrees to subTrees. Nodes the incumbent prunes are
+      counted as discarded and skipped without being decoded. */
+  void decodeFrontier(AlpsEncoded& encoded,
+                      std::vector<AlpsSubTree*>& subTrees) const;
+
   /** Explore the subtree from \c root as the root of the subtree for given
       number of nodes or time, depending on which one reach first.
       Only for serial code. */
@@ -255,11 +293,15 @@ public:
                                    bool & betterSolution);  /* Output */
 
   /** Generate required number (specified by a parameter) of nodes.
-      This function is used by master and hubs. */
+      This function is used by master and hubs. It stops early once it
+      has processed <code>nodeLimit</code> nodes or spent
+      <code>timeLimit</code> seconds of wall clock time. */
   virtual int rampUp(int minNumNodes,
                      int requiredNumNodes,
                      int& depth,
-                     AlpsTreeNode* root = NULL);
+                     AlpsTreeNode* root = NULL,
+                     int nodeLimit = ALPS_INT_MAX,
+                     double timeLimit = ALPS_DBL_MAX);
 
   /// Get encode function defined in Alps.
   using AlpsKnowledge::encode;
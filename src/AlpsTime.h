@@ -29,6 +29,8 @@
 
 #include "AlpsConfig.h"
 
+#include <cassert>
+
 #include "Alps.h"
 
 #include "CoinTime.hpp"
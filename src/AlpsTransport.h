@@ -0,0 +1,97 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#ifndef AlpsTransport_h_
+#define AlpsTransport_h_
+
+#include "AlpsConfig.h"
+
+#include <vector>
+
+//#############################################################################
+
+/** Point-to-point messaging between the processes of a parallel search.
+    Messages are byte strings with a tag; between two processes they
+    arrive in the order they were sent. Sends never block: the data must
+    stay valid until testSends() reports the send complete. Receives are
+    polled with probe() and then taken with receive().
+
+    AlpsKnowledgeBrokerMPI sends and receives the messages of the search
+    through a transport. AlpsTransportMPI carries them over MPI;
+    AlpsTransportLocal between threads of one process. The broker itself
+    still needs MPI for ramp-up, termination checks and its collectives,
+    so a search always runs under MPI whatever transport carries its
+    point-to-point messages. */
+class ALPSLIB_EXPORT AlpsTransport {
+
+ private:
+  AlpsTransport(const AlpsTransport&);
+  AlpsTransport& operator=(const AlpsTransport&);
+
+ public:
+  AlpsTransport() {}
+  virtual ~AlpsTransport() {}
+
+  /** @name Query methods */
+  //@{
+  /** The rank of this process, from 0 to size() - 1. */
+  virtual int rank() const = 0;
+  /** The number of processes. */
+  virtual int size() const = 0;
+  //@}
+
+  /** Start sending headSize bytes of head followed by bodySize bytes of
+      body as one message to dest. body may be NULL if bodySize is 0.
+      handle is a non-negative number chosen by the caller, not used by
+      another send in progress, that testSends() returns once both
+      pieces may be reused. */
+  virtual void send(int dest, int tag,
+                    const char* head, int headSize,
+                    const char* body, int bodySize,
+                    int handle) = 0;
+
+  /** Append the handles of the sends that completed since the last call
+      to done. Never blocks. */
+  virtual void testSends(std::vector<int>& done) = 0;
+
+  /** Finish all sends in progress, cancelling those that no receive has
+      matched, and append their handles to done. Blocks until all are
+      finished. Meant for the end of a search, when no process receives
+      any more. */
+  virtual void cancelSends(std::vector<int>& done) = 0;
+
+  /** Return true if a message is waiting, and set its source, tag and
+      size in bytes. The message must be received before the next
+      probe(). Never blocks. */
+  virtual bool probe(int& source, int& tag, int& size) = 0;
+
+  /** Receive the message found by the last successful probe() into buf,
+      which holds at least its size. */
+  virtual void receive(char* buf) = 0;
+};
+
+#endif
@@ -0,0 +1,215 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#include <cstring>
+#include <thread>
+
+#include "CoinError.hpp"
+
+#include "AlpsTransportLocal.h"
+
+//#############################################################################
+
+AlpsLocalNetwork::AlpsLocalNetwork(int size)
+  :
+  size_(size),
+  mailboxes_(NULL)
+{
+  if (size_ < 1) {
+    throw CoinError("Need at least one rank", "AlpsLocalNetwork",
+                    "AlpsLocalNetwork");
+  }
+  mailboxes_ = new std::atomic<AlpsLocalMessage*> [size_];
+  for (int k = 0; k < size_; ++k) {
+    mailboxes_[k].store(NULL);
+  }
+}
+
+//#############################################################################
+
+AlpsLocalNetwork::~AlpsLocalNetwork()
+{
+  for (int k = 0; k < size_; ++k) {
+    AlpsLocalMessage* msg = mailboxes_[k].load();
+    while (msg) {
+      AlpsLocalMessage* next = msg->next;
+      delete msg;
+      msg = next;
+    }
+  }
+  delete [] mailboxes_;
+}
+
+//#############################################################################
+
+void
+AlpsLocalNetwork::post(int dest, AlpsLocalMessage* msg)
+{
+  if (dest < 0 || dest >= size_) {
+    delete msg;
+    throw CoinError("Invalid rank", "post", "AlpsLocalNetwork");
+  }
+
+  // Push onto the stack; on failure msg->next is reloaded with the top.
+  msg->next = mailboxes_[dest].load(std::memory_order_relaxed);
+  while (!mailboxes_[dest].compare_exchange_weak(msg->next, msg,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+  }
+}
+
+//#############################################################################
+
+AlpsLocalMessage*
+AlpsLocalNetwork::takeAll(int dest)
+{
+  if (mailboxes_[dest].load(std::memory_order_relaxed) == NULL) {
+    return NULL;
+  }
+  return mailboxes_[dest].exchange(NULL, std::memory_order_acquire);
+}
+
+//#############################################################################
+
+void
+AlpsLocalNetwork::run(const std::function<void (AlpsTransport&)>& body)
+{
+  std::vector<std::thread> threads;
+  for (int k = 0; k < size_; ++k) {
+    threads.push_back(std::thread([this, k, &body]() {
+          AlpsTransportLocal transport(this, k);
+          body(transport);
+        }));
+  }
+  for (int k = 0; k < size_; ++k) {
+    threads[k].join();
+  }
+}
+
+//#############################################################################
+
+AlpsTransportLocal::AlpsTransportLocal(AlpsLocalNetwork* network, int rank)
+  :
+  network_(network),
+  rank_(rank),
+  probed_(false)
+{
+  if (rank_ < 0 || rank_ >= network_->size()) {
+    throw CoinError("Invalid rank", "AlpsTransportLocal",
+                    "AlpsTransportLocal");
+  }
+}
+
+//#############################################################################
+
+AlpsTransportLocal::~AlpsTransportLocal()
+{
+  for (size_t k = 0; k < inbox_.size(); ++k) {
+    delete inbox_[k];
+  }
+}
+
+//#############################################################################
+
+void
+AlpsTransportLocal::send(int dest, int tag,
+                         const char* head, int headSize,
+                         const char* body, int bodySize,
+                         int handle)
+{
+  AlpsLocalMessage* msg = new AlpsLocalMessage;
+  msg->next = NULL;
+  msg->source = rank_;
+  msg->tag = tag;
+  msg->data.reserve(headSize + bodySize);
+  msg->data.insert(msg->data.end(), head, head + headSize);
+  if (bodySize > 0) {
+    msg->data.insert(msg->data.end(), body, body + bodySize);
+  }
+  network_->post(dest, msg);
+
+  // The data was copied, so the send is complete.
+  completed_.push_back(handle);
+}
+
+//#############################################################################
+
+void
+AlpsTransportLocal::testSends(std::vector<int>& done)
+{
+  done.insert(done.end(), completed_.begin(), completed_.end());
+  completed_.clear();
+}
+
+//#############################################################################
+
+bool
+AlpsTransportLocal::probe(int& source, int& tag, int& size)
+{
+  if (probed_) {
+    throw CoinError("The probed message was not received", "probe",
+                    "AlpsTransportLocal");
+  }
+
+  if (inbox_.empty()) {
+    // The stack holds the newest message first.
+    AlpsLocalMessage* msg = network_->takeAll(rank_);
+    while (msg) {
+      inbox_.push_front(msg);
+      msg = msg->next;
+    }
+    if (inbox_.empty()) {
+      return false;
+    }
+  }
+
+  const AlpsLocalMessage* msg = inbox_.front();
+  source = msg->source;
+  tag = msg->tag;
+  size = static_cast<int>(msg->data.size());
+  probed_ = true;
+  return true;
+}
+
+//#############################################################################
+
+void
+AlpsTransportLocal::receive(char* buf)
+{
+  if (!probed_) {
+    throw CoinError("No message was probed", "receive",
+                    "AlpsTransportLocal");
+  }
+
+  AlpsLocalMessage* msg = inbox_.front();
+  inbox_.pop_front();
+  probed_ = false;
+  if (!msg->data.empty()) {
+    memcpy(buf, &msg->data[0], msg->data.size());
+  }
+  delete msg;
+}
@@ -0,0 +1,146 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#ifndef AlpsTransportLocal_h_
+#define AlpsTransportLocal_h_
+
+#include "AlpsConfig.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "AlpsTransport.h"
+
+//#############################################################################
+
+/** A message between two threads of an AlpsLocalNetwork. */
+struct AlpsLocalMessage {
+  /** The message pushed before this one to the same mailbox. */
+  AlpsLocalMessage* next;
+  /** Rank of the sender. */
+  int source;
+  /** Tag of the message. */
+  int tag;
+  /** Copy of the message. */
+  std::vector<char> data;
+};
+
+//#############################################################################
+
+/** The mailboxes of a group of threads that play the processes of a
+    parallel search. Each mailbox is a lock-free stack: senders push with
+    a compare-and-swap, and its owner takes the whole stack at once and
+    restores the order in which the messages were sent.
+
+    The threads exchange messages only: AlpsKnowledgeBrokerMPI still
+    calls MPI directly outside its point-to-point messages, so a network
+    serves to test the messaging layer without mpirun, not to run a
+    search. */
+class ALPSLIB_EXPORT AlpsLocalNetwork {
+
+ private:
+  /** The number of ranks. */
+  int size_;
+  /** Top of the mailbox of each rank, the last message pushed. */
+  std::atomic<AlpsLocalMessage*>* mailboxes_;
+
+  AlpsLocalNetwork(const AlpsLocalNetwork&);
+  AlpsLocalNetwork& operator=(const AlpsLocalNetwork&);
+
+ public:
+  /** Create empty mailboxes for the given number of ranks. */
+  AlpsLocalNetwork(int size);
+  /** Free the messages that were never received. */
+  ~AlpsLocalNetwork();
+
+  /** The number of ranks. */
+  int size() const { return size_; }
+
+  /** Add msg to the mailbox of dest. The network takes ownership of
+      msg. Safe to call from any thread. */
+  void post(int dest, AlpsLocalMessage* msg);
+
+  /** Take all messages in the mailbox of dest, last pushed first. The
+      caller takes ownership of them. Only the thread of dest may call
+      it. */
+  AlpsLocalMessage* takeAll(int dest);
+
+  /** Run body in one thread per rank, each given a transport of its
+      own, and return when all have returned. */
+  void run(const std::function<void (AlpsTransport&)>& body);
+};
+
+//#############################################################################
+
+/** Transport between the threads of an AlpsLocalNetwork. A send copies
+    the message into the mailbox of the receiver and is complete at once.
+    Each transport must be used by one thread only. */
+class ALPSLIB_EXPORT AlpsTransportLocal : public AlpsTransport {
+
+ private:
+  /** The network, not owned. */
+  AlpsLocalNetwork* network_;
+  /** The rank of this thread. */
+  int rank_;
+  /** Messages taken from the mailbox, oldest first. */
+  std::deque<AlpsLocalMessage*> inbox_;
+  /** Handles of the sends not yet returned by testSends(). */
+  std::vector<int> completed_;
+  /** Whether the front of inbox_ was probed. */
+  bool probed_;
+
+  AlpsTransportLocal(const AlpsTransportLocal&);
+  AlpsTransportLocal& operator=(const AlpsTransportLocal&);
+
+ public:
+  /** Play the given rank of the network, which must outlive the
+      transport. */
+  AlpsTransportLocal(AlpsLocalNetwork* network, int rank);
+  /** Free the messages taken but not received. */
+  virtual ~AlpsTransportLocal();
+
+  virtual int rank() const { return rank_; }
+  virtual int size() const { return network_->size(); }
+
+  virtual void send(int dest, int tag,
+                    const char* head, int headSize,
+                    const char* body, int bodySize,
+                    int handle);
+
+  virtual void testSends(std::vector<int>& done);
+
+  /** Sends are complete at once, so this is testSends(). */
+  virtual void cancelSends(std::vector<int>& done) { testSends(done); }
+
+  virtual bool probe(int& source, int& tag, int& size);
+
+  virtual void receive(char* buf);
+};
+
+#endif
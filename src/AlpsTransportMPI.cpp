@@ -0,0 +1,176 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#include "CoinError.hpp"
+
+#include "AlpsTransportMPI.h"
+
+//#############################################################################
+
+AlpsTransportMPI::AlpsTransportMPI(MPI_Comm comm)
+  :
+  comm_(comm),
+  rank_(0),
+  size_(0),
+  message_(MPI_MESSAGE_NULL),
+  messageSize_(0)
+{
+  MPI_Comm_rank(comm_, &rank_);
+  MPI_Comm_size(comm_, &size_);
+}
+
+//#############################################################################
+
+AlpsTransportMPI::~AlpsTransportMPI()
+{
+  for (size_t k = 0; k < types_.size(); ++k) {
+    if (types_[k] != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&types_[k]);
+    }
+  }
+}
+
+//#############################################################################
+
+void
+AlpsTransportMPI::send(int dest, int tag,
+                       const char* head, int headSize,
+                       const char* body, int bodySize,
+                       int handle)
+{
+  if (handle < 0) {
+    throw CoinError("Negative handle", "send", "AlpsTransportMPI");
+  }
+  if (handle >= static_cast<int>(requests_.size())) {
+    requests_.resize(handle + 1, MPI_REQUEST_NULL);
+    types_.resize(handle + 1, MPI_DATATYPE_NULL);
+  }
+
+  if (bodySize == 0) {
+    MPI_Isend(const_cast<char*>(head), headSize, MPI_PACKED, dest, tag,
+              comm_, &requests_[handle]);
+    return;
+  }
+
+  // Address both pieces from MPI_BOTTOM.
+  int blockLengths[2] = { headSize, bodySize };
+  MPI_Aint displacements[2];
+  MPI_Get_address(const_cast<char*>(head), &displacements[0]);
+  MPI_Get_address(const_cast<char*>(body), &displacements[1]);
+  MPI_Type_create_hindexed(2, blockLengths, displacements, MPI_BYTE,
+                           &types_[handle]);
+  MPI_Type_commit(&types_[handle]);
+  MPI_Isend(MPI_BOTTOM, 1, types_[handle], dest, tag, comm_,
+            &requests_[handle]);
+}
+
+//#############################################################################
+
+void
+AlpsTransportMPI::testSends(std::vector<int>& done)
+{
+  if (requests_.empty()) {
+    return;
+  }
+
+  int numDone = 0;
+  indices_.resize(requests_.size());
+  MPI_Testsome(static_cast<int>(requests_.size()), &requests_[0],
+               &numDone, &indices_[0], MPI_STATUSES_IGNORE);
+  if (numDone == MPI_UNDEFINED) {
+    return;
+  }
+
+  for (int k = 0; k < numDone; ++k) {
+    const int handle = indices_[k];
+    if (types_[handle] != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&types_[handle]);
+    }
+    done.push_back(handle);
+  }
+}
+
+//#############################################################################
+
+void
+AlpsTransportMPI::cancelSends(std::vector<int>& done)
+{
+  for (size_t handle = 0; handle < requests_.size(); ++handle) {
+    if (requests_[handle] == MPI_REQUEST_NULL) {
+      continue;
+    }
+    int flag = 0;
+    MPI_Test(&requests_[handle], &flag, MPI_STATUS_IGNORE);
+    if (!flag) {
+      // A cancelled send always completes; one matched meanwhile completes
+      // normally.
+      MPI_Cancel(&requests_[handle]);
+      MPI_Wait(&requests_[handle], MPI_STATUS_IGNORE);
+    }
+    if (types_[handle] != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&types_[handle]);
+    }
+    done.push_back(static_cast<int>(handle));
+  }
+}
+
+//#############################################################################
+
+bool
+AlpsTransportMPI::probe(int& source, int& tag, int& size)
+{
+  if (message_ != MPI_MESSAGE_NULL) {
+    throw CoinError("The probed message was not received", "probe",
+                    "AlpsTransportMPI");
+  }
+
+  int flag = 0;
+  MPI_Status status;
+  MPI_Improbe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm_, &flag, &message_,
+              &status);
+  if (!flag) {
+    return false;
+  }
+
+  source = status.MPI_SOURCE;
+  tag = status.MPI_TAG;
+  MPI_Get_count(&status, MPI_PACKED, &size);
+  messageSize_ = size;
+  return true;
+}
+
+//#############################################################################
+
+void
+AlpsTransportMPI::receive(char* buf)
+{
+  if (message_ == MPI_MESSAGE_NULL) {
+    throw CoinError("No message was probed", "receive", "AlpsTransportMPI");
+  }
+
+  MPI_Mrecv(buf, messageSize_, MPI_PACKED, &message_, MPI_STATUS_IGNORE);
+}
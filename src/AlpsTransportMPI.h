@@ -0,0 +1,92 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+
+
+#ifndef AlpsTransportMPI_h_
+#define AlpsTransportMPI_h_
+
+#include "AlpsConfig.h"
+
+#include <vector>
+
+#include <mpi.h>
+
+#include "AlpsTransport.h"
+
+//#############################################################################
+
+/** Transport over an MPI communicator. Messages are sent with MPI_Isend as
+    MPI_PACKED data; a message in two pieces is described by a derived
+    datatype, so neither piece is copied. */
+class ALPSLIB_EXPORT AlpsTransportMPI : public AlpsTransport {
+
+ private:
+  /** The communicator, not owned. */
+  MPI_Comm comm_;
+  /** Rank in comm_. */
+  int rank_;
+  /** Size of comm_. */
+  int size_;
+  /** Request of each handle, MPI_REQUEST_NULL if not in use. */
+  std::vector<MPI_Request> requests_;
+  /** Datatype of each handle sent in two pieces, otherwise
+      MPI_DATATYPE_NULL. */
+  std::vector<MPI_Datatype> types_;
+  /** Scratch space for MPI_Testsome. */
+  std::vector<int> indices_;
+  /** The message found by probe(). */
+  MPI_Message message_;
+  /** Its size in bytes. */
+  int messageSize_;
+
+  AlpsTransportMPI(const AlpsTransportMPI&);
+  AlpsTransportMPI& operator=(const AlpsTransportMPI&);
+
+ public:
+  /** Use the given communicator, which must outlive the transport. */
+  AlpsTransportMPI(MPI_Comm comm);
+  /** Free the datatypes. Sends in progress should be finished with
+      cancelSends() first. */
+  virtual ~AlpsTransportMPI();
+
+  virtual int rank() const { return rank_; }
+  virtual int size() const { return size_; }
+
+  virtual void send(int dest, int tag,
+                    const char* head, int headSize,
+                    const char* body, int bodySize,
+                    int handle);
+
+  virtual void testSends(std::vector<int>& done);
+
+  virtual void cancelSends(std::vector<int>& done);
+
+  virtual bool probe(int& source, int& tag, int& size);
+
+  virtual void receive(char* buf);
+};
+
+#endif
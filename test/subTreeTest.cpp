@@ -0,0 +1,423 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+// Tests the ways a subtree is taken apart and put back together when work
+// moves between processes: AlpsSubTree::splitFrontier() and
+// decodeFrontier(), and encode() and decode(). No search is run; the tree
+// is built by hand and the broker only provides the parameters, the
+// decoders and the incumbent.
+
+#include "AlpsConfig.h"
+
+#include <iostream>
+#include <vector>
+
+#include "CoinError.hpp"
+
+#include "AlpsKnowledgeBroker.h"
+#include "AlpsModel.h"
+#include "AlpsNodeDesc.h"
+#include "AlpsSubTree.h"
+#include "AlpsTreeNode.h"
+
+//#############################################################################
+
+/** Number of failed checks. */
+static int numFailures = 0;
+
+static void
+check(bool cond, const char* what)
+{
+  if (!cond) {
+    ++numFailures;
+    std::cerr << what << std::endl;
+  }
+}
+
+//#############################################################################
+
+/** An empty node description. */
+class TestNodeDesc : public AlpsNodeDesc {
+public:
+  virtual AlpsKnowledge* decode(AlpsEncoded& encoded) const {
+    return new TestNodeDesc;
+  }
+};
+
+/** A node that carries nothing but the Alps part. */
+class TestTreeNode : public AlpsTreeNode {
+public:
+  TestTreeNode() { desc_ = new TestNodeDesc; }
+
+  virtual AlpsTreeNode* createNewTreeNode(AlpsNodeDesc*& desc) const {
+    TestTreeNode* node = new TestTreeNode;
+    delete node->desc_;
+    node->desc_ = desc;
+    desc = NULL;
+    return node;
+  }
+  virtual int process(bool isRoot = false, bool rampUp = false) {
+    return AlpsReturnStatusOk;
+  }
+  virtual std::vector< CoinTriple<AlpsNodeDesc*, AlpsNodeStatus, double> >
+  branch() {
+    return std::vector< CoinTriple<AlpsNodeDesc*, AlpsNodeStatus,
+                                   double> >();
+  }
+  virtual AlpsKnowledge* decode(AlpsEncoded& encoded) const {
+    TestTreeNode* node = new TestTreeNode;
+    node->decodeToSelf(encoded);
+    return node;
+  }
+};
+
+/** A model with nothing to solve. */
+class TestModel : public AlpsModel {
+public:
+  virtual AlpsTreeNode* createRoot() { return new TestTreeNode; }
+  virtual AlpsKnowledge* decode(AlpsEncoded& encoded) const {
+    return new TestModel;
+  }
+};
+
+/** A broker that never searches and whose incumbent is set by the test. */
+class TestBroker : public AlpsKnowledgeBroker {
+public:
+  double incumbent_;
+
+  TestBroker(AlpsModel& model)
+    :
+    AlpsKnowledgeBroker(model),
+    incumbent_(ALPS_INC_MAX)
+  {
+    model.setBroker(this);
+    messageHandler()->setLogLevel(0);
+    setNodeSelection(new AlpsNodeSelectionBest);
+    registerClass(AlpsKnowledgeTypeNode, new TestTreeNode);
+  }
+
+  virtual void initializeSearch(int argc, char* argv[], AlpsModel& model,
+                                bool showBanner = true) {}
+  virtual void rootSearch(AlpsTreeNode* root) {}
+  virtual void searchLog() {}
+  virtual double getIncumbentValue() const { return incumbent_; }
+  virtual double getBestQuality() const { return incumbent_; }
+  virtual void printBestSolution(char* outputFile = 0) const {}
+};
+
+//#############################################################################
+
+static TestTreeNode*
+newNode(TestBroker& broker, AlpsTreeNode* parent, int index, double quality,
+        AlpsNodeStatus status, int numChildren)
+{
+  TestTreeNode* node = new TestTreeNode;
+  node->setBroker(&broker);
+  node->setIndex(index);
+  node->setQuality(quality);
+  node->setStatus(status);
+  node->setNumChildren(numChildren);
+  node->setExplicit(1);
+  node->setParent(parent);
+  if (parent) {
+    node->setDepth(parent->getDepth() + 1);
+    node->setParentIndex(parent->getIndex());
+  }
+  else {
+    node->setDepth(0);
+  }
+  return node;
+}
+
+/** Link the children to their parent, whose child count is already set. */
+static void
+setChildren(AlpsTreeNode* parent, const std::vector<AlpsTreeNode*>& children)
+{
+  for (int i = 0; i < static_cast<int>(children.size()); ++i) {
+    parent->setChild(i, children[i]);
+  }
+}
+
+/** Build the subtree
+ *
+ *       0 (branched)
+ *      / \
+ *     1   2 (candidate, quality 1)
+ *     |
+ *     3 (candidate, quality 2)
+ *
+ *  where node 1 is branched. Nodes 2 and 3 are in the node pool. */
+static AlpsSubTree*
+buildTree(TestBroker& broker)
+{
+  TestTreeNode* root = newNode(broker, NULL, 0, 0.0,
+                               AlpsNodeStatusBranched, 2);
+  TestTreeNode* inner = newNode(broker, root, 1, 0.5,
+                                AlpsNodeStatusBranched, 1);
+  TestTreeNode* leafA = newNode(broker, root, 2, 1.0,
+                                AlpsNodeStatusCandidate, 0);
+  TestTreeNode* leafB = newNode(broker, inner, 3, 2.0,
+                                AlpsNodeStatusCandidate, 0);
+  setChildren(root, std::vector<AlpsTreeNode*>{inner, leafA});
+  setChildren(inner, std::vector<AlpsTreeNode*>{leafB});
+
+  AlpsSubTree* st = new AlpsSubTree(&broker);
+  st->setNodeSelection(broker.getNodeSelection());
+  st->setRoot(root);
+  st->nodePool()->addKnowledge(leafA, leafA->getQuality());
+  st->nodePool()->addKnowledge(leafB, leafB->getQuality());
+  return st;
+}
+
+static int
+countNodes(AlpsTreeNode* node)
+{
+  int num = 1;
+  for (int i = 0; i < node->getNumChildren(); ++i) {
+    num += countNodes(node->getChild(i));
+  }
+  return num;
+}
+
+/** The child of parent with the given index, or NULL. */
+static AlpsTreeNode*
+findChild(AlpsTreeNode* parent, int index)
+{
+  for (int i = 0; i < parent->getNumChildren(); ++i) {
+    if (parent->getChild(i)->getIndex() == index) {
+      return parent->getChild(i);
+    }
+  }
+  return NULL;
+}
+
+static void
+deleteAll(std::vector<AlpsSubTree*>& subTrees)
+{
+  for (int k = 0; k < static_cast<int>(subTrees.size()); ++k) {
+    delete subTrees[k];
+  }
+  subTrees.clear();
+}
+
+//#############################################################################
+
+/** Donate half of the open nodes, keeping or deleting dead nodes. */
+static void
+testSplitHalf(TestBroker& broker, bool deleteDeadNode)
+{
+  AlpsParams* par = broker.getModel()->AlpsPar();
+  const bool oldDeleteDeadNode = par->entry(AlpsParams::deleteDeadNode);
+  par->setEntry(AlpsParams::deleteDeadNode, deleteDeadNode);
+  AlpsSubTree* st = buildTree(broker);
+  AlpsTreeNode* root = st->getRoot();
+  AlpsTreeNode* inner = root->getChild(0);
+
+  // Node 2 comes first in best-first order and stays; node 3 goes.
+  int numNodes = 0;
+  AlpsEncoded* encoded = st->splitFrontier(numNodes, false);
+  check(encoded != NULL && numNodes == 1, "half: wrong number of nodes");
+  check(st->nodePool()->getNumKnowledges() == 1 &&
+        static_cast<AlpsTreeNode*>
+        (st->nodePool()->getKnowledge().first)->getIndex() == 2,
+        "half: wrong node kept");
+
+  // Node 1 lost its only child, so it is fathomed either way.
+  if (deleteDeadNode) {
+    check(root->getNumChildren() == 1 &&
+          root->getChild(0)->getIndex() == 2,
+          "half: dead parent not removed");
+    check(countNodes(root) == 2, "half: wrong tree size");
+  }
+  else {
+    check(root->getNumChildren() == 2 && inner->getNumChildren() == 0 &&
+          inner->getStatus() == AlpsNodeStatusFathomed,
+          "half: childless parent not fathomed");
+    check(countNodes(root) == 3, "half: wrong tree size");
+  }
+  check(root->getStatus() == AlpsNodeStatusBranched,
+        "half: root status changed");
+
+  // The receiver makes the node the root of a subtree of its own.
+  std::vector<AlpsSubTree*> subTrees;
+  if (encoded) {
+    st->decodeFrontier(*encoded, subTrees);
+  }
+  check(subTrees.size() == 1, "half: wrong number of subtrees");
+  if (subTrees.size() == 1) {
+    AlpsTreeNode* newRoot = subTrees[0]->getRoot();
+    check(newRoot->getIndex() == 3 && newRoot->getParent() == NULL &&
+          newRoot->getQuality() == 2.0 && newRoot->getDepth() == 2 &&
+          newRoot->getStatus() == AlpsNodeStatusCandidate,
+          "half: wrong root");
+    check(subTrees[0]->nodePool()->getNumKnowledges() == 1,
+          "half: root not in node pool");
+  }
+
+  deleteAll(subTrees);
+  delete encoded;
+  delete st;
+  par->setEntry(AlpsParams::deleteDeadNode, oldDeleteDeadNode);
+}
+
+//#############################################################################
+
+/** Donate all open nodes, with and without an incumbent pruning some. */
+static void
+testSplitWhole(TestBroker& broker)
+{
+  AlpsSubTree* st = buildTree(broker);
+
+  int numNodes = 0;
+  AlpsEncoded* encoded = st->splitFrontier(numNodes, true);
+  check(encoded != NULL && numNodes == 2, "whole: wrong number of nodes");
+  // The subtree is left as it was, to be deleted by the caller.
+  check(countNodes(st->getRoot()) == 4 &&
+        st->getRoot()->getChild(0)->getNumChildren() == 1,
+        "whole: tree changed");
+
+  std::vector<AlpsSubTree*> subTrees;
+  if (encoded) {
+    st->decodeFrontier(*encoded, subTrees);
+  }
+  check(subTrees.size() == 2, "whole: wrong number of subtrees");
+  if (subTrees.size() == 2) {
+    check(subTrees[0]->getRoot()->getIndex() == 2 &&
+          subTrees[1]->getRoot()->getIndex() == 3 &&
+          subTrees[0]->getRoot()->getParent() == NULL &&
+          subTrees[1]->getRoot()->getParent() == NULL,
+          "whole: wrong roots");
+  }
+  deleteAll(subTrees);
+  delete encoded;
+  delete st;
+
+  // With an incumbent of 1.5, node 3 cannot lead to a better solution.
+  st = buildTree(broker);
+  encoded = st->splitFrontier(numNodes, true);
+  broker.incumbent_ = 1.5;
+  const int numDiscarded = broker.getNumNodesDiscarded();
+  if (encoded) {
+    st->decodeFrontier(*encoded, subTrees);
+  }
+  check(subTrees.size() == 1 && subTrees[0]->getRoot()->getIndex() == 2,
+        "whole: pruned node decoded");
+  check(broker.getNumNodesDiscarded() == numDiscarded + 1,
+        "whole: pruned node not counted");
+  broker.incumbent_ = ALPS_INC_MAX;
+  deleteAll(subTrees);
+  delete encoded;
+  delete st;
+}
+
+//#############################################################################
+
+/** Encode the whole subtree and decode it, with and without an incumbent
+    pruning some of its leaves. */
+static void
+testDecode(TestBroker& broker, bool deleteDeadNode)
+{
+  AlpsParams* par = broker.getModel()->AlpsPar();
+  const bool oldDeleteDeadNode = par->entry(AlpsParams::deleteDeadNode);
+  par->setEntry(AlpsParams::deleteDeadNode, deleteDeadNode);
+  AlpsSubTree* st = buildTree(broker);
+
+  // Without an incumbent the tree comes back as it was.
+  AlpsEncoded* encoded = st->encode();
+  AlpsSubTree* copy = dynamic_cast<AlpsSubTree*>(st->decode(*encoded));
+  delete encoded;
+  AlpsTreeNode* root = copy->getRoot();
+  check(root && root->getIndex() == 0 && countNodes(root) == 4,
+        "decode: wrong tree");
+  if (root && root->getNumChildren() == 2) {
+    AlpsTreeNode* inner = findChild(root, 1);
+    check(inner && inner->getStatus() == AlpsNodeStatusBranched &&
+          inner->getNumChildren() == 1 &&
+          inner->getChild(0)->getIndex() == 3 &&
+          inner->getChild(0)->getParent() == inner,
+          "decode: wrong inner node");
+  }
+  check(copy->nodePool()->getNumKnowledges() == 2,
+        "decode: wrong node pool");
+  delete copy;
+
+  // With an incumbent of 1.5, node 3 is dropped unread. Node 1 is left
+  // without children and is fathomed, as if node 3 had been pruned here.
+  broker.incumbent_ = 1.5;
+  const int numDiscarded = broker.getNumNodesDiscarded();
+  encoded = st->encode();
+  copy = dynamic_cast<AlpsSubTree*>(st->decode(*encoded));
+  delete encoded;
+  check(broker.getNumNodesDiscarded() == numDiscarded + 1,
+        "decode: pruned node not counted");
+  root = copy->getRoot();
+  check(root && root->getStatus() == AlpsNodeStatusBranched,
+        "decode: wrong root");
+  if (root && deleteDeadNode) {
+    check(root->getNumChildren() == 1 && findChild(root, 2) != NULL &&
+          countNodes(root) == 2, "decode: dead node not removed");
+  }
+  else if (root) {
+    AlpsTreeNode* inner = findChild(root, 1);
+    check(root->getNumChildren() == 2 && countNodes(root) == 3 &&
+          inner && inner->getNumChildren() == 0 &&
+          inner->getStatus() == AlpsNodeStatusFathomed,
+          "decode: childless node not fathomed");
+  }
+  check(copy->nodePool()->getNumKnowledges() == 1 &&
+        static_cast<AlpsTreeNode*>
+        (copy->nodePool()->getKnowledge().first)->getIndex() == 2,
+        "decode: wrong node pool");
+  broker.incumbent_ = ALPS_INC_MAX;
+
+  delete copy;
+  delete st;
+  par->setEntry(AlpsParams::deleteDeadNode, oldDeleteDeadNode);
+}
+
+//#############################################################################
+
+int main(int argc, char* argv[])
+{
+  TestModel model;
+  TestBroker broker(model);
+
+  try {
+    testSplitHalf(broker, true);
+    testSplitHalf(broker, false);
+    testSplitWhole(broker);
+    testDecode(broker, true);
+    testDecode(broker, false);
+  }
+  catch (CoinError& er) {
+    check(false, er.message().c_str());
+  }
+
+  std::cout << "AlpsSubTree split and decode: "
+            << (numFailures == 0 ? "passed" : "FAILED") << std::endl;
+  return numFailures == 0 ? 0 : 1;
+}
+
+//#############################################################################
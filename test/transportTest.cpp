@@ -0,0 +1,218 @@
+/*===========================================================================*
+ * This file is part of the Abstract Library for Parallel Search (ALPS).     *
+ *                                                                           *
+ * ALPS is distributed under the Eclipse Public License as part of the       *
+ * COIN-OR repository (http://www.coin-or.org).                              *
+ *                                                                           *
+ * Authors:                                                                  *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Aykut Bulut, Lehigh University                                   *
+ *          Ted Ralphs, Lehigh University                                    *
+ *                                                                           *
+ * Conceptual Design:                                                        *
+ *                                                                           *
+ *          Yan Xu, Lehigh University                                        *
+ *          Ted Ralphs, Lehigh University                                    *
+ *          Laszlo Ladanyi, IBM T.J. Watson Research Center                  *
+ *          Matthew Saltzman, Clemson University                             *
+ *                                                                           *
+ *                                                                           *
+ * Copyright (C) 2001-2023, Lehigh University, Yan Xu, Aykut Bulut, and      *
+ *                          Ted Ralphs.                                      *
+ * All Rights Reserved.                                                      *
+ *===========================================================================*/
+
+// Tests AlpsTransportLocal: every thread of a network sends messages of
+// varying size to every thread, itself included, while receiving. Checks
+// that messages between two threads arrive in order and intact, and that
+// every send handle is reported complete exactly once.
+
+#include "AlpsConfig.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "CoinError.hpp"
+
+#include "AlpsTransportLocal.h"
+
+//#############################################################################
+
+/** Number of failed checks, over all threads. */
+static std::atomic<int> numFailures(0);
+
+static void
+check(bool cond, int rank, const char* what)
+{
+  if (!cond) {
+    ++numFailures;
+    std::cerr << "rank " << rank << ": " << what << std::endl;
+  }
+}
+
+//#############################################################################
+
+/** Number of messages each thread sends to each thread. */
+static const int numMsg = 2000;
+
+static int msgTag(int seq) { return seq % 7; }
+static int msgBodySize(int seq) { return seq % 97; }
+static char msgByte(int source, int seq, int k)
+{
+  return static_cast<char>((source + seq + k) & 0xff);
+}
+
+//#############################################################################
+
+/** The messages received by one thread. */
+struct Receiver {
+  /** Next expected sequence number from each source. */
+  std::vector<int> next;
+  /** Number of messages received. */
+  int count;
+  std::vector<char> buf;
+
+  Receiver(int size) : next(size, 0), count(0) {}
+
+  /** Receive the waiting messages, at most max of them. */
+  void poll(AlpsTransport& transport, int max) {
+    const int rank = transport.rank();
+    int source, tag, size;
+    while (max-- > 0 && transport.probe(source, tag, size)) {
+      buf.resize(size + 1);
+      transport.receive(&buf[0]);
+      ++count;
+
+      check(source >= 0 && source < transport.size(), rank,
+            "invalid source");
+      check(size >= static_cast<int>(2 * sizeof(int)), rank,
+            "message too short");
+      if (source < 0 || source >= transport.size() ||
+          size < static_cast<int>(2 * sizeof(int))) {
+        continue;
+      }
+
+      int head[2];
+      memcpy(head, &buf[0], sizeof(head));
+      const int seq = head[1];
+      check(head[0] == source, rank, "head does not match source");
+      check(seq == next[source], rank, "message out of order");
+      next[source] = seq + 1;
+      check(tag == msgTag(seq), rank, "wrong tag");
+      check(size == static_cast<int>(sizeof(head)) + msgBodySize(seq),
+            rank, "wrong size");
+      if (size != static_cast<int>(sizeof(head)) + msgBodySize(seq)) {
+        continue;
+      }
+      bool intact = true;
+      for (int k = 0; k < msgBodySize(seq); ++k) {
+        intact = intact &&
+          buf[sizeof(head) + k] == msgByte(source, seq, k);
+      }
+      check(intact, rank, "body corrupted");
+    }
+  }
+};
+
+//#############################################################################
+
+static void
+exchange(AlpsTransport& transport)
+{
+  const int rank = transport.rank();
+  const int size = transport.size();
+  Receiver receiver(size);
+  std::vector<int> done;
+  std::vector<char> body(97);
+  int source, tag, msgSize;
+
+  // Misuse is reported.
+  bool thrown = false;
+  try {
+    transport.receive(&body[0]);
+  }
+  catch (CoinError&) {
+    thrown = true;
+  }
+  check(thrown, rank, "receive without probe accepted");
+
+  // Send, with a handle per message, while receiving.
+  for (int seq = 0; seq < numMsg; ++seq) {
+    for (int dest = 0; dest < size; ++dest) {
+      int head[2] = { rank, seq };
+      for (int k = 0; k < msgBodySize(seq); ++k) {
+        body[k] = msgByte(rank, seq, k);
+      }
+      transport.send(dest, msgTag(seq),
+                     reinterpret_cast<const char*>(head), sizeof(head),
+                     msgBodySize(seq) > 0 ? &body[0] : NULL,
+                     msgBodySize(seq), seq * size + dest);
+      // The data may be reused once the send is complete.
+      transport.testSends(done);
+    }
+    receiver.poll(transport, 3);
+  }
+
+  while (receiver.count < size * numMsg && numFailures == 0) {
+    receiver.poll(transport, size * numMsg);
+  }
+  check(!transport.probe(source, tag, msgSize), rank, "extra message");
+
+  // Every handle completed, once.
+  std::sort(done.begin(), done.end());
+  bool complete = static_cast<int>(done.size()) == size * numMsg;
+  for (int k = 0; complete && k < size * numMsg; ++k) {
+    complete = done[k] == k;
+  }
+  check(complete, rank, "handles not completed exactly once");
+  done.clear();
+  transport.testSends(done);
+  check(done.empty(), rank, "handle completed twice");
+
+  // A probed message must be received before the next probe.
+  transport.send(rank, 0, NULL, 0, NULL, 0, 0);
+  check(transport.probe(source, tag, msgSize) && source == rank &&
+        msgSize == 0, rank, "empty message lost");
+  thrown = false;
+  try {
+    transport.probe(source, tag, msgSize);
+  }
+  catch (CoinError&) {
+    thrown = true;
+  }
+  check(thrown, rank, "second probe accepted");
+  transport.receive(NULL);
+}
+
+//#############################################################################
+
+static void
+runTest(int size)
+{
+  AlpsLocalNetwork network(size);
+  network.run([](AlpsTransport& transport) {
+      try {
+        exchange(transport);
+      }
+      catch (CoinError& er) {
+        check(false, transport.rank(), er.message().c_str());
+      }
+    });
+  std::cout << "AlpsTransportLocal with " << size << " threads: "
+            << (numFailures == 0 ? "passed" : "FAILED") << std::endl;
+}
+
+//#############################################################################
+
+int main(int argc, char* argv[])
+{
+  runTest(1);
+  runTest(8);
+  return numFailures == 0 ? 0 : 1;
+}
+
+//#############################################################################